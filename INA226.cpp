@@ -1,6 +1,6 @@
 //    FILE: INA226.cpp
 //  AUTHOR: Rob Tillaart
-// VERSION: 0.6.4
+// VERSION: 0.7.0
 //    DATE: 2021-05-18
 // PURPOSE: Arduino library for INA226 power sensor
 //     URL: https://github.com/RobTillaart/INA226
@@ -22,6 +22,9 @@
 #define INA226_MANUFACTURER               0xFE
 #define INA226_DIE_ID                     0xFF
 
+//  not a register, marks the register pointer of the device as unknown.
+#define INA226_POINTER_UNKNOWN            0x80
+
 
 //  CONFIGURATION MASKS
 #define INA226_CONF_RESET_MASK            0x8000
@@ -30,6 +33,22 @@
 #define INA226_CONF_SHUNTVC_MASK          0x0038
 #define INA226_CONF_MODE_MASK             0x0007
 
+//  power on default of the CONFIGURATION register
+#define INA226_CONF_DEFAULT               0x4127
+//  modes 5..7 convert continuously, 0 and 4 are power down.
+#define INA226_MODE_CONTINUOUS            0x04
+
+//  waitConversionReady() polling interval, micros
+#define INA226_POLL_MIN_US                20
+#define INA226_POLL_MAX_US                1000
+
+
+//  typical conversion times BVCT SVCT in micros, see ina226_timing_enum
+static const uint16_t INA226_CONVERSION_TIME[8] =
+{
+  140, 204, 332, 588, 1100, 2100, 4200, 8300
+};
+
 
 ////////////////////////////////////////////////////////
 //
@@ -44,12 +63,45 @@ INA226::INA226(const uint8_t address, TwoWire *wire)
   _maxCurrent  = 0;
   _shunt       = 0;
   _error       = 0;
+  _valid       = true;
+  _retries     = 0;
+  _pointer     = INA226_POINTER_UNKNOWN;
+  //  cached registers, power on defaults.
+  _config      = INA226_CONF_DEFAULT;
+  _maskEnable  = 0;
+  _calibration = 0;
+  _alertLimit  = 0;
+  _alertFunction = 0;
+  _alertValue  = 0;
+  _configBatch = false;
+  _autoRange   = false;
+  _range       = 0;
+  _rangeCalibration0 = 0;
+  _rangeLSB0   = 0;
+  _rangeMaxCurrent0 = 0;
+  _rangeSwitches = 0;
+  _current_zero_offset_uA = 0;
+  //  integer scaling without float math, see _calcIntegerScaling()
+  _clearCurrentScaling();
+  _bus_mul         = 40960;     //  1.25 mV = 40960 >> 15
+  _bus_shift       = 15;
+  _converting      = false;
+  _conversionStart = 0;
+  _activeTime      = 0;
+  _callback        = NULL;
+  _alertPending    = false;
+  _alertFlags      = 0;
+#ifdef INA226_BUS_STATISTICS
+  resetBusStatistics();
+#endif
 }
 
 
 bool INA226::begin()
 {
   if (! isConnected()) return false;
+  //  device may not be in power on state, e.g. after a restart of the MCU.
+  refreshConfig();
   return true;
 }
 
@@ -93,6 +145,8 @@ float INA226::getShuntVoltage()
 
 float INA226::getCurrent()
 {
+  //  the register may still hold a conversion of the previous range.
+  if (_autoRange) return 0;
   int16_t val = _readRegister(INA226_CURRENT);
   return val * _current_LSB - _current_zero_offset;
 }
@@ -100,45 +154,275 @@ float INA226::getCurrent()
 
 float INA226::getPower()
 {
+  if (_autoRange) return 0;
   uint16_t val = _readRegister(INA226_POWER);
   return val * (_current_LSB * 25);  //  fixed 25 Watt
 }
 
 
+int16_t INA226::getShuntVoltageRaw()
+{
+  return _readRegister(INA226_SHUNT_VOLTAGE);
+}
+
+
+uint16_t INA226::getBusVoltageRaw()
+{
+  return _readRegister(INA226_BUS_VOLTAGE);
+}
+
+
+int16_t INA226::getCurrentRaw()
+{
+  if (_autoRange) return 0;
+  return _readRegister(INA226_CURRENT);
+}
+
+
+uint16_t INA226::getPowerRaw()
+{
+  if (_autoRange) return 0;
+  return _readRegister(INA226_POWER);
+}
+
+
+int32_t INA226::convertShuntVoltage_uV(int16_t raw)
+{
+  return ((int32_t)raw * 5) / 2;   //  fixed 2.50 uV
+}
+
+
+int32_t INA226::convertBusVoltage_mV(uint16_t raw)
+{
+  uint32_t value = (uint32_t)raw * _bus_mul;
+  if (_bus_shift >= 0) return value >> _bus_shift;
+  return value << -_bus_shift;
+}
+
+
+int32_t INA226::convertCurrent_uA(int16_t raw)
+{
+  int32_t value = (int32_t)raw * _current_mul;
+  if (_current_shift >= 0) value >>= _current_shift;
+  else                     value <<= -_current_shift;
+  return value - _current_zero_offset_uA;
+}
+
+
+uint32_t INA226::convertPower_uW(uint16_t raw)
+{
+  uint32_t value = (uint32_t)raw * _power_mul;
+  if (_power_shift >= 0) return value >> _power_shift;
+  return value << -_power_shift;
+}
+
+
 bool INA226::isConversionReady()
 {
   uint16_t mask = _readRegister(INA226_MASK_ENABLE);
+  _alertFlags = mask & 0x001F;
   return (mask & INA226_CONVERSION_READY_FLAG) == INA226_CONVERSION_READY_FLAG;
 }
 
 
 bool INA226::waitConversionReady(uint32_t timeout)
 {
-  uint32_t start = millis();
+  uint32_t start  = millis();
+  uint32_t period = getConversionPeriod_us();
+
+  //  sleep until just before the predicted end of the conversion,
+  //  no I2C traffic. Real conversion times differ a few % from typical.
+  if (_converting && (period > 0))
+  {
+    uint32_t elapsed = micros() - _conversionStart;
+    uint32_t wakeup  = period - period / 16;
+    if (elapsed < wakeup)
+    {
+      uint32_t sleep = wakeup - elapsed;
+      if (sleep / 1000 > timeout) sleep = timeout * 1000;
+      delay(sleep / 1000);  //  implicit yield();
+      delayMicroseconds(sleep % 1000);
+    }
+  }
+
+  //  fine grained polling, proportional to the conversion period.
+  uint32_t interval = period / 64;
+  if (interval < INA226_POLL_MIN_US) interval = INA226_POLL_MIN_US;
+  if (interval > INA226_POLL_MAX_US) interval = INA226_POLL_MAX_US;
   while ( (millis() - start) <= timeout)
   {
-    if (isConversionReady()) return true;
-    delay(1);  //  implicit yield();
+    if (isConversionReady())
+    {
+      if ((_config & INA226_MODE_CONTINUOUS) == 0)
+      {
+        _converting = false;
+      }
+      _conversionStart = micros();
+      return true;
+    }
+    if (interval >= 1000) delay(1);  //  implicit yield();
+    else delayMicroseconds(interval);
   }
   return false;
 }
 
 
+bool INA226::startConversion()
+{
+  //  writing the CONFIGURATION register starts a new conversion.
+  return (_writeRegister(INA226_CONFIGURATION, _config) == 0);
+}
+
+
+bool INA226::poll()
+{
+  //  no conversion running, prevent useless I2C traffic.
+  if (! _converting) return false;
+  if (! isConversionReady()) return false;
+  //  in continuous mode the next conversion starts immediately.
+  if ((_config & INA226_MODE_CONTINUOUS) == 0)
+  {
+    _converting = false;
+  }
+  _conversionStart = micros();
+  if (_callback != NULL) _callback(this);
+  return true;
+}
+
+
+bool INA226::readSample(INA226Sample & sample)
+{
+  //  a sample has no range, its raw current and power cannot be scaled.
+  if (_autoRange) return false;
+  sample.timestamp = micros();
+  sample.shunt     = _readRegister(INA226_SHUNT_VOLTAGE);
+  if (_error != 0) return false;
+  sample.bus       = _readRegister(INA226_BUS_VOLTAGE);
+  if (_error != 0) return false;
+  sample.current   = _readRegister(INA226_CURRENT);
+  if (_error != 0) return false;
+  sample.power     = _readRegister(INA226_POWER);
+  return (_error == 0);
+}
+
+
+bool INA226::read(INA226Reading & reading)
+{
+  if (! isConversionReady()) return false;
+  bool overflow = (_alertFlags & INA226_MATH_OVERFLOW_FLAG) != 0;
+  //  in triggered mode the device stops after the conversion,
+  //  the result registers cannot change during the reads.
+  bool continuous = (_config & INA226_MODE_CONTINUOUS) != 0;
+  uint8_t attempts = 0;
+  while (true)
+  {
+    reading.timestamp  = micros();
+    reading.shuntRaw   = _readRegister(INA226_SHUNT_VOLTAGE);
+    if (_error != 0) return false;
+    reading.busRaw     = _readRegister(INA226_BUS_VOLTAGE);
+    if (_error != 0) return false;
+    reading.currentRaw = _readRegister(INA226_CURRENT);
+    if (_error != 0) return false;
+    reading.powerRaw   = _readRegister(INA226_POWER);
+    if (_error != 0) return false;
+    if (! continuous) break;
+    //  a new conversion finished during the reads, values may be mixed.
+    if (! isConversionReady())
+    {
+      if (_error != 0) return false;
+      break;
+    }
+    overflow = (_alertFlags & INA226_MATH_OVERFLOW_FLAG) != 0;
+    attempts++;
+    if (attempts >= INA226_READ_ATTEMPTS) return false;
+  }
+  if (! continuous) _converting = false;
+  _conversionStart = micros();
+
+  reading.overflow     = overflow;
+  reading.shuntVoltage = reading.shuntRaw * 2.5e-6;
+  reading.busVoltage   = reading.busRaw * 1.25e-3;
+  if (_bus_V_scaling_e4 != 10000)
+  {
+    reading.busVoltage *= _bus_V_scaling_e4 * 1.0e-4;
+  }
+  reading.current      = reading.currentRaw * _current_LSB - _current_zero_offset;
+  reading.power        = reading.powerRaw * (_current_LSB * 25);
+  reading.currentLSB   = _current_LSB;
+  //  after scaling, the reading keeps the range of its conversion.
+  if (_autoRange) autoRange(reading.shuntRaw);
+  return true;
+}
+
+
+bool INA226::measureOnce(INA226Sample & sample, uint32_t timeout)
+{
+  if (_autoRange) return false;
+  uint32_t start = micros();
+  //  trigger shunt and bus, keeps averaging and conversion times.
+  _config &= ~INA226_CONF_MODE_MASK;
+  _config |= 0x03;
+  bool rv = (_writeRegister(INA226_CONFIGURATION, _config) == 0);
+  rv = rv && waitConversionReady(timeout);
+  if (rv)
+  {
+    sample.timestamp = micros();
+    sample.shunt     = _readRegister(INA226_SHUNT_VOLTAGE);
+    rv = (_error == 0);
+  }
+  if (rv)
+  {
+    sample.bus       = _readRegister(INA226_BUS_VOLTAGE);
+    rv = (_error == 0);
+  }
+  if (rv)
+  {
+    sample.current   = _readRegister(INA226_CURRENT);
+    rv = (_error == 0);
+  }
+  //  power down, also after an error.
+  _config &= ~INA226_CONF_MODE_MASK;
+  if (_writeRegister(INA226_CONFIGURATION, _config) != 0) rv = false;
+  _converting = false;
+  _activeTime = micros() - start;
+  if (rv)
+  {
+    //  the device calculates POWER = CURRENT x BUS / 20000, saves a read.
+    int32_t current = sample.current;
+    if (current < 0) current = -current;
+    sample.power = ((uint32_t)current * sample.bus) / 20000;
+  }
+  return rv;
+}
+
+
 ////////////////////////////////////////////////////////
 //
 //  CONFIGURATION
 //
 bool INA226::reset()
 {
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
-  mask |= INA226_CONF_RESET_MASK;
+  uint16_t mask = _config | INA226_CONF_RESET_MASK;
   uint16_t result = _writeRegister(INA226_CONFIGURATION, mask);
   //  Serial.println(result);
   if (result != 0) return false;
+  //  device resets its register pointer too.
+  _pointer     = INA226_POINTER_UNKNOWN;
+  //  reset cached registers
+  _config      = INA226_CONF_DEFAULT;
+  _maskEnable  = 0;
+  _calibration = 0;
+  _alertLimit  = 0;
+  _alertFunction = 0;
+  _alertValue  = 0;
+  _configBatch = false;
+  _autoRange   = false;
+  _range       = 0;
   //  reset calibration
   _current_LSB = 0;
   _maxCurrent  = 0;
   _shunt       = 0;
+  _clearCurrentScaling();
   return true;
 }
 
@@ -146,17 +430,13 @@ bool INA226::reset()
 bool INA226::setAverage(uint8_t avg)
 {
   if (avg > 7) return false;
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
-  mask &= ~INA226_CONF_AVERAGE_MASK;
-  mask |= (avg << 9);
-  _writeRegister(INA226_CONFIGURATION, mask);
-  return true;
+  return _updateConfig(INA226_CONF_AVERAGE_MASK, avg << 9);
 }
 
 
 uint8_t INA226::getAverage()
 {
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
+  uint16_t mask = _config;
   mask &= INA226_CONF_AVERAGE_MASK;
   mask >>= 9;
   return mask;
@@ -166,17 +446,13 @@ uint8_t INA226::getAverage()
 bool INA226::setBusVoltageConversionTime(uint8_t bvct)
 {
   if (bvct > 7) return false;
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
-  mask &= ~INA226_CONF_BUSVC_MASK;
-  mask |= (bvct << 6);
-  _writeRegister(INA226_CONFIGURATION, mask);
-  return true;
+  return _updateConfig(INA226_CONF_BUSVC_MASK, bvct << 6);
 }
 
 
 uint8_t INA226::getBusVoltageConversionTime()
 {
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
+  uint16_t mask = _config;
   mask &= INA226_CONF_BUSVC_MASK;
   mask >>= 6;
   return mask;
@@ -186,23 +462,118 @@ uint8_t INA226::getBusVoltageConversionTime()
 bool INA226::setShuntVoltageConversionTime(uint8_t svct)
 {
   if (svct > 7) return false;
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
-  mask &= ~INA226_CONF_SHUNTVC_MASK;
-  mask |= (svct << 3);
-  _writeRegister(INA226_CONFIGURATION, mask);
-  return true;
+  return _updateConfig(INA226_CONF_SHUNTVC_MASK, svct << 3);
 }
 
 
 uint8_t INA226::getShuntVoltageConversionTime()
 {
-  uint16_t mask = _readRegister(INA226_CONFIGURATION);
+  uint16_t mask = _config;
   mask &= INA226_CONF_SHUNTVC_MASK;
   mask >>= 3;
   return mask;
 }
 
 
+uint32_t INA226::getConversionPeriod_us()
+{
+  uint8_t  mode = _config & INA226_CONF_MODE_MASK;
+  uint32_t period = 0;
+  if (mode & 0x01) period += INA226_CONVERSION_TIME[getShuntVoltageConversionTime()];
+  if (mode & 0x02) period += INA226_CONVERSION_TIME[getBusVoltageConversionTime()];
+  //  1, 4, 16, 64, 128, 256, 512, 1024 samples
+  uint8_t avg = getAverage();
+  if (avg < 4) period <<= (avg * 2);
+  else         period <<= (avg + 3);
+  return period;
+}
+
+
+float INA226::getSampleRate()
+{
+  uint32_t period = getConversionPeriod_us();
+  if (period == 0) return 0;
+  return 1e6 / period;
+}
+
+
+bool INA226::setSampleRate(float rate, uint8_t mode, uint8_t minTime)
+{
+  if ((rate <= 0) || (mode > 7) || (minTime > 7)) return false;
+  if ((mode == 0) || (mode == 4)) return false;
+  //  clamp, longest cycle is 1024 x (8300 + 8300) us ~ 17 seconds.
+  float budget = 1e6 / rate;
+  if (budget > 1e8) budget = 1e8;
+  uint32_t target = budget;
+
+  //  exhaustive search, 512 combinations, integer math only.
+  //  best = most averaging that fits, then longest cycle,
+  //  then longest shunt conversion time.
+  uint8_t  bestAvg    = 0;
+  uint32_t bestPeriod = 0;
+  uint16_t bestConfig = 0;
+  for (uint8_t avg = 0; avg < 8; avg++)
+  {
+    for (uint8_t svct = minTime; svct < 8; svct++)
+    {
+      for (uint8_t bvct = minTime; bvct < 8; bvct++)
+      {
+        //  unused channel => use the minimal time only.
+        if (((mode & 0x01) == 0) && (svct != minTime)) continue;
+        if (((mode & 0x02) == 0) && (bvct != minTime)) continue;
+        uint32_t period = 0;
+        if (mode & 0x01) period += INA226_CONVERSION_TIME[svct];
+        if (mode & 0x02) period += INA226_CONVERSION_TIME[bvct];
+        if (avg < 4) period <<= (avg * 2);
+        else         period <<= (avg + 3);
+        if (period > target) continue;
+        //  avg ascending, later svct => longer shunt conversion time.
+        if ((avg > bestAvg) || (period >= bestPeriod))
+        {
+          bestAvg    = avg;
+          bestPeriod = period;
+          bestConfig = (avg << 9) | (bvct << 6) | (svct << 3) | mode;
+        }
+      }
+    }
+  }
+  if (bestPeriod == 0) return false;
+
+  uint16_t mask = INA226_CONF_AVERAGE_MASK | INA226_CONF_BUSVC_MASK
+                | INA226_CONF_SHUNTVC_MASK | INA226_CONF_MODE_MASK;
+  return _updateConfig(mask, bestConfig);
+}
+
+
+void INA226::beginConfig()
+{
+  _configBatch = true;
+}
+
+
+bool INA226::commitConfig()
+{
+  _configBatch = false;
+  return (_writeRegister(INA226_CONFIGURATION, _config) == 0);
+}
+
+
+bool INA226::refreshConfig()
+{
+  uint16_t value = _readRegister(INA226_CONFIGURATION);
+  if (_error != 0) return false;
+  _config = value;
+  _converting = ((_config & INA226_CONF_MODE_MASK) > INA226_MODE_CONTINUOUS);
+  value = _readRegister(INA226_MASK_ENABLE);
+  if (_error != 0) return false;
+  _maskEnable = value & 0xFC00;
+  value = _readRegister(INA226_CALIBRATION);
+  if (_error != 0) return false;
+  _calibration = value;
+  return true;
+}
+
+
 ////////////////////////////////////////////////////////
 //
 //  CALIBRATION
@@ -222,6 +593,8 @@ int INA226::setMaxCurrentShunt(float maxCurrent, float shunt, bool normalize)
   if (maxCurrent < 0.001)               return INA226_ERR_MAXCURRENT_LOW;
   if (shunt < INA226_MINIMAL_SHUNT_OHM) return INA226_ERR_SHUNT_LOW;
 
+  _autoRange   = false;
+  _range       = 0;
   _current_LSB = maxCurrent * 3.0517578125e-5;      //  maxCurrent / 32768;
 
 #ifdef printdebug
@@ -291,6 +664,7 @@ int INA226::setMaxCurrentShunt(float maxCurrent, float shunt, bool normalize)
     if (result == false)  //  not succeeded to normalize.
     {
       _current_LSB = 0;
+      _clearCurrentScaling();
       return INA226_ERR_NORMALIZE_FAILED;
     }
 
@@ -309,10 +683,14 @@ int INA226::setMaxCurrentShunt(float maxCurrent, float shunt, bool normalize)
     _current_LSB *= 2;
     calib >>= 1;
   }
-  _writeRegister(INA226_CALIBRATION, calib);
-
   _maxCurrent = _current_LSB * 32768;
   _shunt = shunt;
+  _calcIntegerScaling();
+  if (! _writeCalibration(calib)) return INA226_ERR_WRITE_FAILED;
+  if (! _updateAlertLimit())
+  {
+    return (_alertFunction == 0) ? INA226_ERR_ALERT_DISABLED : INA226_ERR_WRITE_FAILED;
+  }
 
 #ifdef printdebug
   Serial.println("\n***** INA 226 SET VALUES *****");
@@ -342,6 +720,8 @@ int INA226::configure(float shunt, float current_LSB_mA, float current_zero_offs
   float maxCurrent = min((INA226_MAX_SHUNT_VOLTAGE / shunt), 32768 * current_LSB_mA * 1e-3);
   if (maxCurrent < 0.001)               return INA226_ERR_MAXCURRENT_LOW;
 
+  _autoRange           = false;
+  _range               = 0;
   _shunt               = shunt;
   _current_LSB         = current_LSB_mA * 1e-3;
   _current_zero_offset = current_zero_offset_mA * 1e-3;
@@ -349,7 +729,13 @@ int INA226::configure(float shunt, float current_LSB_mA, float current_zero_offs
   _maxCurrent          = maxCurrent;
 
   uint32_t calib = round(0.00512 / (_current_LSB * _shunt));
-  _writeRegister(INA226_CALIBRATION, calib);
+  _current_zero_offset_uA = round(_current_zero_offset * 1e6);
+  _calcIntegerScaling();
+  if (! _writeCalibration(calib)) return INA226_ERR_WRITE_FAILED;
+  if (! _updateAlertLimit())
+  {
+    return (_alertFunction == 0) ? INA226_ERR_ALERT_DISABLED : INA226_ERR_WRITE_FAILED;
+  }
 
 // #define printdebug
 
@@ -375,6 +761,65 @@ int INA226::configure(float shunt, float current_LSB_mA, float current_zero_offs
 }
 
 
+bool INA226::setAutoRange(bool enable)
+{
+  if (! enable)
+  {
+    if (! _autoRange) return true;
+    _autoRange = false;
+    if (_range == 0) return true;
+    return _setRange(0);
+  }
+  if ((_calibration == 0) || (_current_LSB <= 0)) return false;
+  if (! _autoRange)
+  {
+    _rangeCalibration0 = _calibration;
+    _rangeLSB0 = _current_LSB;
+    _rangeMaxCurrent0 = _maxCurrent;
+    _range     = 0;
+  }
+  _autoRange = true;
+  return true;
+}
+
+
+bool INA226::autoRange(int16_t shuntRaw)
+{
+  if (! _autoRange) return false;
+  //  CURRENT = SHUNT x CAL / 2048, the shunt register does not overflow,
+  //  so the range is found in one step, also after a math overflow.
+  uint32_t shunt = abs((int32_t)shuntRaw);
+  int8_t   range = _range;
+  uint32_t cal   = _rangeCalibration(range);
+  //  coarser, with CAL <= 2048 the CURRENT register cannot overflow.
+  while ((cal > 2048) && (((shunt * cal) >> 11) >= INA226_AUTORANGE_HIGH))
+  {
+    range--;
+    cal = _rangeCalibration(range);
+  }
+  //  finer, the hysteresis between LOW and HIGH prevents toggling.
+  if (range == _range)
+  {
+    while ((((shunt * cal) >> 11) < INA226_AUTORANGE_LOW) && (_rangeCalibration(range + 1) <= 32767))
+    {
+      range++;
+      cal = _rangeCalibration(range);
+    }
+  }
+  if (range == _range) return false;
+  //  a typed alert limit can prevent the finest ranges.
+  int8_t step = (range > _range) ? -1 : 1;
+  while (range != _range)
+  {
+    if (_setRange(range)) return true;
+    //  I2C error, the new range is cached, see recover().
+    if (range == _range) return false;
+    range += step;
+  }
+  return false;
+}
+
+
 ////////////////////////////////////////////////////////
 //
 //  OPERATING MODE
@@ -382,17 +827,13 @@ int INA226::configure(float shunt, float current_LSB_mA, float current_zero_offs
 bool INA226::setMode(uint8_t mode)
 {
   if (mode > 7) return false;
-  uint16_t config = _readRegister(INA226_CONFIGURATION);
-  config &= ~INA226_CONF_MODE_MASK;
-  config |= mode;
-  _writeRegister(INA226_CONFIGURATION, config);
-  return true;
+  return _updateConfig(INA226_CONF_MODE_MASK, mode);
 }
 
 
 uint8_t INA226::getMode()
 {
-  uint16_t mode = _readRegister(INA226_CONFIGURATION);
+  uint16_t mode = _config;
   mode &= INA226_CONF_MODE_MASK;
   return mode;
 }
@@ -407,13 +848,27 @@ bool INA226::setAlertRegister(uint16_t mask)
   uint16_t result = _writeRegister(INA226_MASK_ENABLE, (mask & 0xFC00));
   //  Serial.println(result);
   if (result != 0) return false;
+  _maskEnable = mask & 0xFC00;
+  //  another alert function, the typed limit is not converted anymore.
+  if ((_alertFunction != 0) && ((_maskEnable & 0xF800) != _alertFunction))
+  {
+    _alertFunction = 0;
+    _alertValue    = 0;
+  }
   return true;
 }
 
 
+uint16_t INA226::getAlertRegister()
+{
+  return _maskEnable;
+}
+
+
 uint16_t INA226::getAlertFlag()
 {
-  return _readRegister(INA226_MASK_ENABLE) & 0x001F;
+  _alertFlags = _readRegister(INA226_MASK_ENABLE) & 0x001F;
+  return _alertFlags;
 }
 
 
@@ -422,6 +877,9 @@ bool INA226::setAlertLimit(uint16_t limit)
   uint16_t result = _writeRegister(INA226_ALERT_LIMIT, limit);
   //  Serial.println(result);
   if (result != 0) return false;
+  _alertLimit    = limit;
+  _alertFunction = 0;
+  _alertValue    = 0;
   return true;
 }
 
@@ -432,6 +890,82 @@ uint16_t INA226::getAlertLimit()
 }
 
 
+bool INA226::setShuntOverCurrentLimit(float ampere)
+{
+  return _setAlert(INA226_SHUNT_OVER_VOLTAGE, ampere);
+}
+
+
+bool INA226::setShuntUnderCurrentLimit(float ampere)
+{
+  return _setAlert(INA226_SHUNT_UNDER_VOLTAGE, ampere);
+}
+
+
+bool INA226::setBusOverVoltageLimit(float volt)
+{
+  return _setAlert(INA226_BUS_OVER_VOLTAGE, volt);
+}
+
+
+bool INA226::setBusUnderVoltageLimit(float volt)
+{
+  return _setAlert(INA226_BUS_UNDER_VOLTAGE, volt);
+}
+
+
+bool INA226::setPowerOverLimit(float watt)
+{
+  return _setAlert(INA226_POWER_OVER_LIMIT, watt);
+}
+
+
+uint16_t INA226::getAlertEvent()
+{
+  uint16_t flags = getAlertFlag();
+  if (_error != 0) return 0;
+  if (flags & INA226_ALERT_FUNCTION_FLAG)
+  {
+    //  device uses the most significant function bit only.
+    for (uint16_t function = INA226_SHUNT_OVER_VOLTAGE; function >= INA226_POWER_OVER_LIMIT; function >>= 1)
+    {
+      if (_maskEnable & function) return function;
+    }
+  }
+  //  the CVRF flag is also set when the alert is not enabled.
+  if ((flags & INA226_CONVERSION_READY_FLAG) && (_maskEnable & INA226_CONVERSION_READY))
+  {
+    return INA226_CONVERSION_READY;
+  }
+  return 0;
+}
+
+
+bool INA226::enableConversionReadyAlert()
+{
+  return setAlertRegister(_maskEnable | INA226_CONVERSION_READY);
+}
+
+
+bool INA226::serviceAlert(INA226Sample & sample)
+{
+  if (! _alertPending) return false;
+  //  one read of MASK_ENABLE clears the alert, tells its cause
+  //  and replaces the isConversionReady() polling.
+  uint16_t mask = _readRegister(INA226_MASK_ENABLE);
+  //  keep pending, the pin stays asserted until the read succeeds.
+  if (_error != 0) return false;
+  _alertPending = false;
+  _alertFlags = mask & 0x001F;
+  if ((mask & INA226_CONVERSION_READY_FLAG) == 0) return false;
+  if ((_config & INA226_MODE_CONTINUOUS) == 0)
+  {
+    _converting = false;
+  }
+  return readSample(sample);
+}
+
+
 ////////////////////////////////////////////////////////
 //
 //  META INFORMATION
@@ -448,6 +982,15 @@ uint16_t INA226::getDieID()
 }
 
 
+bool INA226::isINA226()
+{
+  if (getManufacturerID() != 0x5449) return false;
+  if (_error != 0) return false;
+  //  bits 15-4 = device ID, bits 3-0 = die revision
+  return ((getDieID() & 0xFFF0) == 0x2260) && (_error == 0);
+}
+
+
 ////////////////////////////////////////////////////////
 //
 //  ERROR HANDLING
@@ -460,40 +1003,338 @@ int INA226::getLastError()
 }
 
 
+bool INA226::recover()
+{
+  if (! isConnected()) return false;
+  _pointer = INA226_POINTER_UNKNOWN;
+  return _writeCachedRegisters();
+}
+
+
+bool INA226::setProfile(const INA226 & profile)
+{
+  if (&profile == this) return _writeCachedRegisters();
+  _current_LSB         = profile._current_LSB;
+  _shunt               = profile._shunt;
+  _maxCurrent          = profile._maxCurrent;
+  _current_zero_offset = profile._current_zero_offset;
+  _bus_V_scaling_e4    = profile._bus_V_scaling_e4;
+  _current_mul         = profile._current_mul;
+  _current_shift       = profile._current_shift;
+  _power_mul           = profile._power_mul;
+  _power_shift         = profile._power_shift;
+  _bus_mul             = profile._bus_mul;
+  _bus_shift           = profile._bus_shift;
+  _current_zero_offset_uA = profile._current_zero_offset_uA;
+  _config              = profile._config;
+  _maskEnable          = profile._maskEnable;
+  _calibration         = profile._calibration;
+  _alertLimit          = profile._alertLimit;
+  _alertFunction       = profile._alertFunction;
+  _alertValue          = profile._alertValue;
+  _configBatch         = false;
+  _autoRange           = profile._autoRange;
+  _range               = profile._range;
+  _rangeCalibration0   = profile._rangeCalibration0;
+  _rangeLSB0           = profile._rangeLSB0;
+  _rangeMaxCurrent0    = profile._rangeMaxCurrent0;
+  return _writeCachedRegisters();
+}
+
+
+bool INA226::busUnlock(uint8_t sda, uint8_t scl)
+{
+  //  release both lines, open drain, pull ups keep them high.
+  pinMode(sda, INPUT_PULLUP);
+  pinMode(scl, INPUT_PULLUP);
+  delayMicroseconds(5);
+  //  max 9 clocks until the slave releases SDA (100 KHz)
+  for (uint8_t i = 0; (i < 9) && (digitalRead(sda) == LOW); i++)
+  {
+    digitalWrite(scl, LOW);
+    pinMode(scl, OUTPUT);
+    delayMicroseconds(5);
+    pinMode(scl, INPUT_PULLUP);
+    delayMicroseconds(5);
+  }
+  //  SCL held low (clock stretching) or SDA still stuck.
+  if (digitalRead(scl) == LOW) return false;
+  if (digitalRead(sda) == LOW) return false;
+  //  START + STOP condition resets the state machine of all slaves.
+  digitalWrite(sda, LOW);
+  pinMode(sda, OUTPUT);
+  delayMicroseconds(5);
+  pinMode(sda, INPUT_PULLUP);
+  delayMicroseconds(5);
+  return (digitalRead(sda) == HIGH);
+}
+
+
 ////////////////////////////////////////////////////////
 //
 //  PRIVATE
 //
+//  bounded retries, see setRetries().
 uint16_t INA226::_readRegister(uint8_t reg)
 {
+  uint16_t value = _readRegisterOnce(reg);
+  for (uint8_t i = 0; (i < _retries) && (_error != 0); i++)
+  {
+    value = _readRegisterOnce(reg);
+  }
+  _valid = (_error == 0);
+  return value;
+}
+
+
+uint16_t INA226::_writeRegister(uint8_t reg, uint16_t value)
+{
+  uint16_t status = _writeRegisterOnce(reg, value);
+  for (uint8_t i = 0; (i < _retries) && (status != 0); i++)
+  {
+    status = _writeRegisterOnce(reg, value);
+  }
+  _valid = (status == 0);
+  return status;
+}
+
+
+uint16_t INA226::_readRegisterOnce(uint8_t reg)
+{
+#ifdef INA226_BUS_STATISTICS
+  uint32_t start = micros();
+#endif
   _error = 0;
-  _wire->beginTransmission(_address);
-  _wire->write(reg);
-  int n = _wire->endTransmission();
-  if (n != 0)
+  uint8_t status = 0;     //  of endTransmission()
+  bool pointerWrite = (reg != _pointer);
+  //  the device keeps its register pointer between transactions,
+  //  so repeated reads of the same register only need the read part.
+  if (pointerWrite)
   {
-    _error = -1;
-    return 0;
+    _wire->beginTransmission(_address);
+    _wire->write(reg);
+    status = _wire->endTransmission();
+    if (status != 0) _error = -1;
+    else             _pointer = reg;
   }
 
   uint16_t value = 0;
-  if (2 == _wire->requestFrom(_address, (uint8_t)2))
+  if (_error == 0)
   {
-    value = _wire->read();
-    value <<= 8;
-    value |= _wire->read();
+    if (2 == _wire->requestFrom(_address, (uint8_t)2))
+    {
+      value = _wire->read();
+      value <<= 8;
+      value |= _wire->read();
+    }
+    else
+    {
+      _error = -2;
+    }
   }
-  else
+  if (_error != 0)
   {
-    _error = -2;
-    return 0;
+    _pointer = INA226_POINTER_UNKNOWN;
   }
+
+#ifdef INA226_BUS_STATISTICS
+  _busStatistics(reg, false, pointerWrite, status, micros() - start);
+#endif
   return value;
 }
 
 
-uint16_t INA226::_writeRegister(uint8_t reg, uint16_t value)
+//  read modify write on the cached CONFIGURATION register.
+//  between beginConfig() and commitConfig() only the cache is updated.
+bool INA226::_updateConfig(uint16_t mask, uint16_t value)
+{
+  _config &= ~mask;
+  _config |= (value & mask);
+  if (_configBatch) return true;
+  return (_writeRegister(INA226_CONFIGURATION, _config) == 0);
+}
+
+
+void INA226::_clearCurrentScaling()
 {
+  _current_mul   = 0;
+  _current_shift = 0;
+  _power_mul     = 0;
+  _power_shift   = 0;
+}
+
+
+//  integer only, used by INA226Fixed.
+bool INA226::_writeCalibration(uint16_t calibration)
+{
+  _calibration = calibration;
+  return (_writeRegister(INA226_CALIBRATION, _calibration) == 0);
+}
+
+
+//  typed alert limit depends on the calibration, convert it again.
+//  if it does not fit anymore the alert function is disabled,
+//  a stale limit would trigger at a different value.
+bool INA226::_updateAlertLimit()
+{
+  if (_alertFunction == 0) return true;
+  uint16_t limit;
+  if (! _convertAlertLimit(_alertFunction, _alertValue, limit))
+  {
+    _alertFunction = 0;
+    _alertValue    = 0;
+    setAlertRegister(_maskEnable & INA226_CONVERSION_READY);
+    return false;
+  }
+  if (_writeRegister(INA226_ALERT_LIMIT, limit) != 0) return false;
+  _alertLimit = limit;
+  return true;
+}
+
+
+//  returns false if a typed alert limit does not fit, nothing changed.
+bool INA226::_setRange(int8_t range)
+{
+  uint16_t calibration = _rangeCalibration(range);
+  //  current_LSB x CAL is constant for a given shunt.
+  float    lsb = _rangeLSB0 * _rangeCalibration0 / calibration;
+  uint16_t previousCalibration = _calibration;
+  float    previousLSB = _current_LSB;
+  _calibration = calibration;
+  _current_LSB = lsb;
+  uint16_t limit;
+  if ((_alertFunction != 0) && ! _convertAlertLimit(_alertFunction, _alertValue, limit))
+  {
+    _calibration = previousCalibration;
+    _current_LSB = previousLSB;
+    return false;
+  }
+  _calcIntegerScaling();
+  _range = range;
+  _rangeSwitches++;
+  //  range 0 keeps the value of setMaxCurrentShunt() or configure().
+  _maxCurrent = _rangeMaxCurrent0;
+  if (range != 0) _maxCurrent = min((float)(INA226_MAX_SHUNT_VOLTAGE / _shunt), lsb * 32768);
+  if (! _writeCalibration(calibration)) return false;
+  if (! _updateAlertLimit()) return false;
+  //  restart a running continuous conversion so the next one uses the
+  //  new calibration only. Writing CONFIGURATION clears the ready flag.
+  if ((_config & INA226_CONF_MODE_MASK) > INA226_MODE_CONTINUOUS)
+  {
+    if (_writeRegister(INA226_CONFIGURATION, _config) != 0) return false;
+    _conversionStart = micros();
+  }
+  return true;
+}
+
+
+uint32_t INA226::_rangeCalibration(int8_t range)
+{
+  if (range >= 0) return (uint32_t)_rangeCalibration0 << range;
+  return _rangeCalibration0 >> -range;
+}
+
+
+//  CONFIGURATION last as it restarts the conversion.
+bool INA226::_writeCachedRegisters()
+{
+  if (_writeRegister(INA226_CALIBRATION, _calibration) != 0) return false;
+  if (_writeRegister(INA226_MASK_ENABLE, _maskEnable) != 0) return false;
+  if (_writeRegister(INA226_ALERT_LIMIT, _alertLimit) != 0) return false;
+  return (_writeRegister(INA226_CONFIGURATION, _config) == 0);
+}
+
+
+bool INA226::_setAlert(uint16_t function, float value)
+{
+  uint16_t limit;
+  if (! _convertAlertLimit(function, value, limit)) return false;
+  //  limit first, prevents a false alert with the old limit.
+  if (! setAlertLimit(limit)) return false;
+  if (! setAlertRegister((_maskEnable & INA226_CONVERSION_READY) | function)) return false;
+  _alertFunction = function;
+  _alertValue    = value;
+  return true;
+}
+
+
+//  engineering units to ALERT_LIMIT register, same format as the
+//  register the function compares with.
+bool INA226::_convertAlertLimit(uint16_t function, float value, uint16_t & limit)
+{
+  float raw = 0;
+  float minimum = 0;
+  float maximum = 32767;
+  switch (function)
+  {
+    case INA226_SHUNT_OVER_VOLTAGE:
+    case INA226_SHUNT_UNDER_VOLTAGE:
+      if ((_calibration == 0) || (_current_LSB <= 0)) return false;
+      //  CURRENT = SHUNT x CAL / 2048  =>  SHUNT = CURRENT x 2048 / CAL
+      raw = (value + _current_zero_offset) / _current_LSB;
+      raw = raw * 2048 / _calibration;
+      minimum = -32768;
+      break;
+    case INA226_BUS_OVER_VOLTAGE:
+    case INA226_BUS_UNDER_VOLTAGE:
+      raw = value / (1.25e-3 * _bus_V_scaling_e4 * 1e-4);
+      break;
+    case INA226_POWER_OVER_LIMIT:
+      if (_current_LSB <= 0) return false;
+      raw = value / (_current_LSB * 25);
+      maximum = 65535;
+      break;
+    default:
+      return false;
+  }
+  raw = round(raw);
+  if ((raw < minimum) || (raw > maximum)) return false;
+  if (raw < 0) limit = (uint16_t)(int16_t)raw;
+  else         limit = (uint16_t)raw;
+  return true;
+}
+
+
+//  derive the integer multipliers from the (float) calibration.
+//  only called when calibration changes, not in the measurement path.
+void INA226::_calcIntegerScaling()
+{
+  _fixedPoint(_current_LSB * 1e6, _current_mul, _current_shift);      //  uA
+  _fixedPoint(_current_LSB * 25e6, _power_mul, _power_shift);         //  uW
+  _fixedPoint(_bus_V_scaling_e4 * 1.25e-4, _bus_mul, _bus_shift);     //  mV
+}
+
+
+//  find mul and shift so that (raw * mul) >> shift ~= raw * scale.
+//  mul is kept as large as possible within 16 bit for precision.
+void INA226::_fixedPoint(float scale, uint16_t &mul, int8_t &shift)
+{
+  shift = 0;
+  if (scale <= 0)
+  {
+    mul = 0;
+    return;
+  }
+  while (scale > 65535)
+  {
+    scale *= 0.5;
+    shift--;
+  }
+  while ((scale * 2 <= 65535) && (shift < 30))
+  {
+    scale *= 2;
+    shift++;
+  }
+  mul = scale + 0.5;
+}
+
+
+uint16_t INA226::_writeRegisterOnce(uint8_t reg, uint16_t value)
+{
+#ifdef INA226_BUS_STATISTICS
+  uint32_t start = micros();
+#endif
+  _error = 0;
   _wire->beginTransmission(_address);
   _wire->write(reg);
   _wire->write(value >> 8);
@@ -502,10 +1343,72 @@ uint16_t INA226::_writeRegister(uint8_t reg, uint16_t value)
   if (n != 0)
   {
     _error = -1;
+    _pointer = INA226_POINTER_UNKNOWN;
+  }
+  else
+  {
+    //  a write also sets the register pointer.
+    _pointer = reg;
+    //  writing CONFIGURATION (re)starts the conversion.
+    if (reg == INA226_CONFIGURATION)
+    {
+      uint8_t mode = value & INA226_CONF_MODE_MASK;
+      _converting = (mode != 0) && (mode != 4);
+      if (value & INA226_CONF_RESET_MASK) _converting = true;
+      _conversionStart = micros();
+    }
   }
+#ifdef INA226_BUS_STATISTICS
+  _busStatistics(reg, true, false, n, micros() - start);
+#endif
   return n;
 }
 
 
+#ifdef INA226_BUS_STATISTICS
+void INA226::resetBusStatistics()
+{
+  memset(&_busStats, 0, sizeof(_busStats));
+}
+
+
+void INA226::_busStatistics(uint8_t reg, bool write, bool pointerWrite, uint8_t status, uint32_t duration)
+{
+  //  register 0x00..0x07 => 0..7, 0xFE => 8, 0xFF => 9
+  uint8_t index = (reg <= INA226_ALERT_LIMIT) ? reg : (reg - INA226_MANUFACTURER + 8);
+  if (index < INA226_BUS_REGISTERS)
+  {
+    if (write) _busStats.writes[index]++;
+    else       _busStats.reads[index]++;
+  }
+  //  bytes of successful transfers only.
+  if (pointerWrite)
+  {
+    _busStats.pointerWrites++;
+    if (status == 0) _busStats.bytes++;
+  }
+  if (write)
+  {
+    if (status == 0) _busStats.bytes += 3;
+  }
+  else if (_error == 0) _busStats.bytes += 2;
+
+  //  [0] read failed, [1..5] endTransmission() status
+  if (status != 0)     _busStats.errors[(status < 5) ? status : 5]++;
+  else if (_error < 0) _busStats.errors[0]++;
+
+  //  bucket n holds durations < (64 << n) us, the last one the rest.
+  uint8_t bucket = 0;
+  duration >>= 6;
+  while (duration && (bucket < INA226_BUS_HISTOGRAM - 1))
+  {
+    duration >>= 1;
+    bucket++;
+  }
+  _busStats.latency[bucket]++;
+}
+#endif
+
+
 //  -- END OF FILE --
 
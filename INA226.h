@@ -1,7 +1,7 @@
 #pragma once
 //    FILE: INA226.h
 //  AUTHOR: Rob Tillaart
-// VERSION: 0.6.4
+// VERSION: 0.7.0
 //    DATE: 2021-05-18
 // PURPOSE: Arduino library for INA226 power sensor
 //     URL: https://github.com/RobTillaart/INA226
@@ -13,7 +13,7 @@
 #include "Wire.h"
 
 
-#define INA226_LIB_VERSION                (F("0.6.4"))
+#define INA226_LIB_VERSION                (F("0.7.0"))
 
 
 //  set by setAlertRegister
@@ -39,15 +39,49 @@
 #define INA226_ERR_MAXCURRENT_LOW         0x8001
 #define INA226_ERR_SHUNT_LOW              0x8002
 #define INA226_ERR_NORMALIZE_FAILED       0x8003
+#define INA226_ERR_ALERT_DISABLED         0x8004
+#define INA226_ERR_WRITE_FAILED           0x8005
 
 //  See issue #26
 #define INA226_MINIMAL_SHUNT_OHM          0.001
 
 #define INA226_MAX_WAIT_MS                600   //  millis
 
+//  read() attempts when a new conversion finished during the reads.
+#define INA226_READ_ATTEMPTS              3
+
+//  auto range thresholds, raw CURRENT register magnitude.
+#define INA226_AUTORANGE_HIGH             24576   //  75% => coarser
+#define INA226_AUTORANGE_LOW              8192    //  25% => finer
+
 #define INA226_MAX_SHUNT_VOLTAGE          (81.92 / 1000)
 
 
+//  I2C bus statistics per device, costs RAM and time.
+//  uncomment here or define as build flag for the whole project to enable.
+//  Do NOT define it in a sketch before #include, it changes the layout of
+//  the INA226 class for that file only (ODR violation, corrupts memory).
+//  #define INA226_BUS_STATISTICS
+
+#ifdef INA226_BUS_STATISTICS
+#define INA226_BUS_REGISTERS              10
+#define INA226_BUS_HISTOGRAM              8
+
+struct INA226BusStatistics
+{
+  //  index register 0x00..0x07 => 0..7, 0xFE => 8, 0xFF => 9
+  uint32_t reads[INA226_BUS_REGISTERS];
+  uint32_t writes[INA226_BUS_REGISTERS];
+  uint32_t pointerWrites;
+  uint32_t bytes;                             //  excluding address bytes
+  //  [0] read failed, [1..5] endTransmission() status
+  uint32_t errors[6];
+  //  transaction duration, bucket n < (64 << n) us, last bucket the rest.
+  uint32_t latency[INA226_BUS_HISTOGRAM];
+};
+#endif
+
+
 //  for setAverage() and getAverage()
 enum ina226_average_enum {
     INA226_1_SAMPLE     = 0,
@@ -74,11 +108,46 @@ enum ina226_timing_enum {
 };
 
 
+//  raw register values of one conversion, see readSample()
+struct INA226Sample
+{
+  uint32_t timestamp;     //  micros
+  int16_t  shunt;         //  LSB = 2.5 uV
+  uint16_t bus;           //  LSB = 1.25 mV
+  int16_t  current;       //  LSB = current_LSB
+  uint16_t power;         //  LSB = 25 x current_LSB
+};
+
+
+//  one coherent conversion, raw and scaled values, see read()
+struct INA226Reading
+{
+  uint32_t timestamp;     //  micros
+  int16_t  shuntRaw;      //  LSB = 2.5 uV
+  uint16_t busRaw;        //  LSB = 1.25 mV
+  int16_t  currentRaw;    //  LSB = current_LSB
+  uint16_t powerRaw;      //  LSB = 25 x current_LSB
+  float    shuntVoltage;  //  Volt
+  float    busVoltage;    //  Volt
+  float    current;       //  Ampere
+  float    power;         //  Watt
+  float    currentLSB;    //  Ampere, LSB of currentRaw, see setAutoRange()
+  bool     overflow;      //  math overflow flag, current and power invalid
+};
+
+
+class INA226;
+
+//  called by poll() when a new conversion is available.
+typedef void (*INA226_callback)(INA226 * ina);
+
+
 class INA226
 {
 public:
   //  address between 0x40 and 0x4F
-  explicit INA226(const uint8_t address, TwoWire *wire = &Wire);
+  //  default address allows arrays of INA226 e.g. for discovery.
+  explicit INA226(const uint8_t address = 0x40, TwoWire *wire = &Wire);
 
   bool     begin();
   bool     isConnected();
@@ -93,6 +162,26 @@ public:
   //  See #35
   bool     isConversionReady();   //  conversion ready flag is set.
   bool     waitConversionReady(uint32_t timeout = INA226_MAX_WAIT_MS);
+  //  Non blocking alternative for waitConversionReady()
+  //  startConversion() triggers a conversion (triggered modes)
+  //  or restarts the running one (continuous modes).
+  bool     startConversion();
+  //  returns true once per finished conversion, does not wait.
+  bool     poll();
+  bool     isConverting()          { return _converting; };
+  void     setConversionCallback(INA226_callback callback) { _callback = callback; };
+  //  read the four result registers (raw), timestamp = micros().
+  bool     readSample(INA226Sample & sample);
+  //  coherent snapshot, all values from the same conversion.
+  //  returns false if no new conversion is available (checked once)
+  //  or a new conversion keeps finishing during the reads.
+  bool     read(INA226Reading & reading);
+  //  single shot: trigger (1 write), wait predicted time, read shunt,
+  //  bus and current, power down (1 write). Power is calculated.
+  //  device stays in power down mode, configuration is kept.
+  bool     measureOnce(INA226Sample & sample, uint32_t timeout = INA226_MAX_WAIT_MS);
+  //  duration of the last measureOnce(), trigger to power down.
+  uint32_t getActiveTime_us()      { return _activeTime; };
 
 
   //  Scale helpers milli range
@@ -107,7 +196,27 @@ public:
   float    getPower_uW()        { return getPower()        * 1e6; };
 
 
+  //  Raw register values, no math.
+  int16_t  getShuntVoltageRaw();  //  LSB = 2.5 uV
+  uint16_t getBusVoltageRaw();    //  LSB = 1.25 mV
+  int16_t  getCurrentRaw();       //  LSB = current_LSB
+  uint16_t getPowerRaw();         //  LSB = 25 x current_LSB
+  //  Integer helpers, no float math, for processors without FPU.
+  //  use precomputed multipliers set by calibration.
+  int32_t  getShuntVoltageInt_uV() { return convertShuntVoltage_uV(getShuntVoltageRaw()); };
+  int32_t  getBusVoltageInt_mV()   { return convertBusVoltage_mV(getBusVoltageRaw()); };
+  //  current and power return 0 when auto range is enabled, use read().
+  int32_t  getCurrentInt_uA()      { return _autoRange ? 0 : convertCurrent_uA(getCurrentRaw()); };
+  uint32_t getPowerInt_uW()        { return _autoRange ? 0 : convertPower_uW(getPowerRaw()); };
+  //  convert raw register values
+  int32_t  convertShuntVoltage_uV(int16_t raw);
+  int32_t  convertBusVoltage_mV(uint16_t raw);
+  int32_t  convertCurrent_uA(int16_t raw);
+  uint32_t convertPower_uW(uint16_t raw);
+
+
   //  Configuration
+  //  getters return the cached CONFIGURATION register.
   bool     reset();
   bool     setAverage(uint8_t avg = INA226_1_SAMPLE);
   uint8_t  getAverage();
@@ -115,6 +224,23 @@ public:
   uint8_t  getBusVoltageConversionTime();
   bool     setShuntVoltageConversionTime(uint8_t svct = INA226_1100_us);
   uint8_t  getShuntVoltageConversionTime();
+  //  duration of one conversion cycle for the current mode,
+  //  averaging and conversion times, typical values.
+  //  returns 0 in power down mode.
+  uint32_t getConversionPeriod_us();
+  float    getSampleRate();
+  //  selects AVG, BVCT and SVCT with the most averaging that still meets
+  //  the rate (conversions per second) and applies them in one write.
+  //  mode selects channels and continuous / triggered, see setMode().
+  //  minTime is the minimal conversion time, e.g. for a noise floor.
+  //  returns false if the rate cannot be met, configuration is not changed.
+  bool     setSampleRate(float rate, uint8_t mode = 7, uint8_t minTime = INA226_140_us);
+  //  batch configuration, setters between begin and commit
+  //  only update the cache, commitConfig() writes them at once.
+  void     beginConfig();
+  bool     commitConfig();
+  //  reload the cached registers from the device, called by begin().
+  bool     refreshConfig();
 
 
   //  Calibration
@@ -124,6 +250,8 @@ public:
   //  shunt * maxCurrent <= 81.9 mV otherwise returns INA226_ERR_SHUNTVOLTAGE_HIGH
   //  maxCurrent >= 0.001           otherwise returns INA226_ERR_MAXCURRENT_LOW
   //  shunt      >= 0.001           otherwise returns INA226_ERR_SHUNT_LOW
+  //  typed alert limit does not fit  alert disabled, returns INA226_ERR_ALERT_DISABLED
+  //  I2C error                       returns INA226_ERR_WRITE_FAILED
   int      setMaxCurrentShunt(float maxCurrent = 20.0, float shunt = 0.002, bool normalize = true);
   //  configure provides full user control, not requiring call to setMaxCurrentShunt(args) function
   int      configure(float shunt = 0.1, float current_LSB_mA = 0.1, float current_zero_offset_mA = 0, uint16_t bus_V_scaling_e4 = 10000);
@@ -135,6 +263,26 @@ public:
   float    getCurrentLSB_uA() { return _current_LSB * 1e6; };
   float    getShunt()         { return _shunt;             };
   float    getMaxCurrent()    { return _maxCurrent;        };
+  uint16_t getCalibration()   { return _calibration;       };
+  float    getCurrentZeroOffset() { return _current_zero_offset; };
+
+  //  Auto range
+  //  adapts the CALIBRATION register and current_LSB in factors of 2
+  //  to the load. The calibration at enable is range 0, so call it
+  //  after setMaxCurrentShunt() or configure(), which disable it.
+  //  disable restores range 0.
+  //  when enabled only read() is valid, readSample() and measureOnce()
+  //  fail and getCurrent(), getPower() and their raw and integer
+  //  variants return 0. Sample based classes e.g. INA226Energy,
+  //  INA226Statistics and INA226Queue do not work with auto range.
+  bool     setAutoRange(bool enable);
+  bool     getAutoRange()          { return _autoRange; };
+  //  called by read() when enabled, or with the shuntRaw of a reading.
+  //  returns true if the range changed.
+  bool     autoRange(int16_t shuntRaw);
+  //  0 = calibration at enable, > 0 finer, < 0 coarser.
+  int8_t   getRange()              { return _range; };
+  uint32_t getRangeSwitches()      { return _rangeSwitches; };
 
 
   //  Operating mode
@@ -156,9 +304,38 @@ public:
   //    same as voltage registers ?
   //  - how to test
   bool     setAlertRegister(uint16_t mask);
+  uint16_t getAlertRegister();   //  cached mask
   uint16_t getAlertFlag();
   bool     setAlertLimit(uint16_t limit);
   uint16_t getAlertLimit();
+  //  flags of the last read of the MASK_ENABLE register.
+  uint16_t getLastAlertFlag()      { return _alertFlags; };
+
+  //  Alert limits in engineering units, set alert function + limit.
+  //  only one alert function can be active, CONVERSION_READY is kept.
+  //  the limit is converted again when the calibration changes.
+  //  returns false if not calibrated, out of range or I2C error.
+  bool     setShuntOverCurrentLimit(float ampere);
+  bool     setShuntUnderCurrentLimit(float ampere);
+  bool     setBusOverVoltageLimit(float volt);
+  bool     setBusUnderVoltageLimit(float volt);
+  bool     setPowerOverLimit(float watt);
+  //  limit in ampere, volt or watt of the active function, 0 if raw.
+  float    getAlertLimitValue()    { return _alertValue; };
+  //  reads MASK_ENABLE, returns the function that fired e.g.
+  //  INA226_BUS_UNDER_VOLTAGE, or INA226_CONVERSION_READY, or 0.
+  uint16_t getAlertEvent();
+
+
+  //  ALERT pin interrupt
+  //  enables the CONVERSION_READY alert, keeps other alert bits.
+  bool     enableConversionReadyAlert();
+  //  call from the ISR attached to the ALERT pin (FALLING).
+  void     alertInterrupt()        { _alertPending = true; };
+  bool     isAlertPending()        { return _alertPending; };
+  //  call from loop(), returns true if the pending alert had a new conversion
+  //  and the sample was read.
+  bool     serviceAlert(INA226Sample & sample);
 
 
   //  Meta information
@@ -166,6 +343,8 @@ public:
   //                               typical value
   uint16_t getManufacturerID();  //  0x5449
   uint16_t getDieID();           //  0x2260
+  //  checks both ID registers, any die revision.
+  bool     isINA226();
 
 
   //  DEBUG
@@ -175,11 +354,49 @@ public:
   //  ERROR HANDLING
   //
   int      getLastError();
-
-private:
+  //  true if the last register access succeeded, also after getLastError().
+  //  use it to tell a failed read (returns 0) from a real zero.
+  bool     isValid()               { return _valid; };
+  //  extra attempts per register access on an I2C error, default 0.
+  void     setRetries(uint8_t retries) { _retries = retries; };
+  uint8_t  getRetries()            { return _retries; };
+  //  after a bus fault or power loss, rewrites the cached CALIBRATION,
+  //  MASK_ENABLE, ALERT_LIMIT and CONFIGURATION registers.
+  bool     recover();
+  //  copy calibration, configuration and alert settings of another
+  //  INA226 object and write them: CALIBRATION, MASK_ENABLE,
+  //  ALERT_LIMIT and CONFIGURATION, 4 transactions, no float math.
+  bool     setProfile(const INA226 & profile);
+  //  clock out a slave that holds SDA low, then a STOP condition.
+  //  call Wire.begin() afterwards. returns true if SDA is released.
+  static bool busUnlock(uint8_t sda, uint8_t scl);
+
+#ifdef INA226_BUS_STATISTICS
+  const INA226BusStatistics & getBusStatistics() { return _busStats; };
+  void     resetBusStatistics();
+#endif
+
+protected:
 
   uint16_t _readRegister(uint8_t reg);
   uint16_t _writeRegister(uint8_t reg, uint16_t value);
+  uint16_t _readRegisterOnce(uint8_t reg);
+  uint16_t _writeRegisterOnce(uint8_t reg, uint16_t value);
+  bool     _updateConfig(uint16_t mask, uint16_t value);
+  void     _calcIntegerScaling();
+  void     _clearCurrentScaling();
+  bool     _writeCalibration(uint16_t calibration);
+  bool     _updateAlertLimit();
+  bool     _setRange(int8_t range);
+  uint32_t _rangeCalibration(int8_t range);
+  bool     _writeCachedRegisters();
+  bool     _setAlert(uint16_t function, float value);
+  bool     _convertAlertLimit(uint16_t function, float value, uint16_t & limit);
+  void     _fixedPoint(float scale, uint16_t &mul, int8_t &shift);
+#ifdef INA226_BUS_STATISTICS
+  void     _busStatistics(uint8_t reg, bool write, bool pointerWrite, uint8_t status, uint32_t duration);
+  INA226BusStatistics _busStats;
+#endif
 
   float    _current_LSB;
   float    _shunt;
@@ -187,10 +404,51 @@ private:
   float    _current_zero_offset = 0;
   uint16_t _bus_V_scaling_e4 = 10000;
 
+  //  integer scaling, value = (raw * mul) >> shift
+  uint16_t _current_mul;
+  int8_t   _current_shift;
+  uint16_t _power_mul;
+  int8_t   _power_shift;
+  uint16_t _bus_mul;
+  int8_t   _bus_shift;
+  int32_t  _current_zero_offset_uA;
+
   uint8_t   _address;
   TwoWire * _wire;
 
   int       _error;
+  bool      _valid;
+  uint8_t   _retries;
+  //  last register addressed, to skip redundant pointer writes.
+  uint8_t   _pointer;
+
+  //  non blocking conversion
+  bool      _converting;
+  uint32_t  _conversionStart;
+  uint32_t  _activeTime;
+  INA226_callback _callback;
+
+  //  ALERT
+  volatile bool _alertPending;
+  uint16_t  _alertFlags;
+
+  //  cached registers
+  uint16_t  _config;
+  uint16_t  _maskEnable;
+  uint16_t  _calibration;
+  uint16_t  _alertLimit;
+  //  typed alert limit, 0 == raw limit.
+  uint16_t  _alertFunction;
+  float     _alertValue;
+  bool      _configBatch;
+
+  //  auto range, range 0 calibration.
+  bool      _autoRange;
+  int8_t    _range;
+  uint16_t  _rangeCalibration0;
+  float     _rangeLSB0;
+  float     _rangeMaxCurrent0;
+  uint32_t  _rangeSwitches;
 };
 
 
@@ -0,0 +1,266 @@
+//    FILE: INA226Array.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - multi device scheduler
+//     URL: https://github.com/RobTillaart/INA226
+
+
+#include "INA226Array.h"
+
+
+//  minimal time between two polls of a device that is not ready yet.
+//  the real conversion time can be ~10% longer than typical.
+#define INA226_ARRAY_MIN_RETRY_US         100
+//  backoff of a quarantined device.
+#define INA226_ARRAY_MAX_BACKOFF_US       1000000UL
+
+
+INA226Array::INA226Array()
+{
+  _count    = 0;
+  _next     = 0;
+  _callback = NULL;
+  _samples  = 0;
+  _start    = 0;
+  _faults   = 0;
+  _recoveries = 0;
+  _skew     = 0;
+}
+
+
+bool INA226Array::add(INA226 * ina)
+{
+  if (ina == NULL) return false;
+  if (_count >= INA226_ARRAY_MAX_DEVICES) return false;
+  _devices[_count] = ina;
+  _due[_count] = micros();
+  _failures[_count] = 0;
+  _count++;
+  return true;
+}
+
+
+INA226 * INA226Array::get(uint8_t index)
+{
+  if (index >= _count) return NULL;
+  return _devices[index];
+}
+
+
+uint8_t INA226Array::discover(INA226 * pool, uint8_t size, TwoWire * wire)
+{
+  uint8_t found = 0;
+  for (uint8_t address = 0x40; address <= 0x4F; address++)
+  {
+    if ((found >= size) || (_count >= INA226_ARRAY_MAX_DEVICES)) break;
+    INA226 * ina = &pool[found];
+    *ina = INA226(address, wire);
+    //  ACK probe first, no ID reads on empty addresses.
+    if (! ina->isConnected()) continue;
+    if (! ina->isINA226()) continue;
+    //  cache the registers of the device, as add() expects.
+    if (! ina->begin()) continue;
+    add(ina);
+    found++;
+  }
+  return found;
+}
+
+
+bool INA226Array::setProfile(const INA226 & profile)
+{
+  bool rv = true;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    rv = _devices[i]->setProfile(profile) && rv;
+  }
+  return rv;
+}
+
+
+bool INA226Array::begin()
+{
+  bool rv = true;
+  //  the start of the conversions is staggered by the I2C transactions.
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    _failures[i] = 0;
+    if (_devices[i]->startConversion())
+    {
+      _due[i] = micros() + _devices[i]->getConversionPeriod_us();
+    }
+    else
+    {
+      _fault(i);
+      rv = false;
+    }
+  }
+  _next = 0;
+  resetStatistics();
+  return rv;
+}
+
+
+uint8_t INA226Array::update()
+{
+  uint8_t ready = 0;
+  for (uint8_t n = 0; n < _count; n++)
+  {
+    uint8_t i = _next + n;
+    if (i >= _count) i -= _count;
+
+    //  not due yet => no I2C traffic.
+    uint32_t now = micros();
+    if ((int32_t)(now - _due[i]) < 0) continue;
+
+    INA226 * ina = _devices[i];
+    uint32_t period = ina->getConversionPeriod_us();
+    //  faulty device, rewrite its registers, this restarts the conversion.
+    if (_failures[i] > 0)
+    {
+      if (ina->recover())
+      {
+        _failures[i] = 0;
+        _recoveries++;
+        _due[i] = micros() + period;
+      }
+      else
+      {
+        _fault(i);
+      }
+      continue;
+    }
+    if (ina->poll())
+    {
+      ready++;
+      _samples++;
+      if (_callback != NULL) _callback(i, ina);
+      //  triggered modes need a new trigger.
+      if (! ina->isConverting() && ! ina->startConversion())
+      {
+        _fault(i);
+        continue;
+      }
+      _due[i] = micros() + period;
+    }
+    else if (! ina->isValid())
+    {
+      _fault(i);
+    }
+    else
+    {
+      //  conversion takes longer than typical, retry a bit later.
+      uint32_t retry = period / 16;
+      if (retry < INA226_ARRAY_MIN_RETRY_US) retry = INA226_ARRAY_MIN_RETRY_US;
+      _due[i] = now + retry;
+    }
+  }
+  //  next call starts with the next device, fair share of the bus.
+  if (_count > 0)
+  {
+    _next++;
+    if (_next >= _count) _next = 0;
+  }
+  return ready;
+}
+
+
+bool INA226Array::trigger()
+{
+  bool rv = true;
+  //  no other I2C traffic between the writes.
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    rv = _devices[i]->startConversion() && rv;
+    _triggerTime[i] = micros();
+  }
+  _skew = (_count > 0) ? (_triggerTime[_count - 1] - _triggerTime[0]) : 0;
+  return rv;
+}
+
+
+uint32_t INA226Array::getTriggerTime(uint8_t index)
+{
+  if (index >= _count) return 0;
+  return _triggerTime[index];
+}
+
+
+bool INA226Array::readFrame(INA226Sample * frame, uint32_t timeout)
+{
+  bool rv = true;
+  for (uint8_t i = 0; i < _count; i++)
+  {
+    //  after the first device the others are (almost) ready.
+    INA226 * ina = _devices[i];
+    if (ina->waitConversionReady(timeout) && ina->readSample(frame[i]))
+    {
+      frame[i].timestamp = _triggerTime[i];
+      _samples++;
+    }
+    else
+    {
+      rv = false;
+    }
+  }
+  return rv;
+}
+
+
+bool INA226Array::acquireFrame(INA226Sample * frame, uint32_t timeout)
+{
+  if (! trigger()) return false;
+  return readFrame(frame, timeout);
+}
+
+
+float INA226Array::getSamplesPerSecond()
+{
+  uint32_t duration = micros() - _start;
+  if (duration == 0) return 0;
+  return _samples * 1e6 / duration;
+}
+
+
+void INA226Array::resetStatistics()
+{
+  _samples = 0;
+  _start   = micros();
+}
+
+
+uint8_t INA226Array::getFailures(uint8_t index)
+{
+  if (index >= _count) return 0;
+  return _failures[index];
+}
+
+
+bool INA226Array::isQuarantined(uint8_t index)
+{
+  if (index >= _count) return false;
+  return _failures[index] >= INA226_ARRAY_QUARANTINE;
+}
+
+
+////////////////////////////////////////////////////////
+//
+//  PRIVATE
+//
+//  exponential backoff, 200 us, 400 us, ... until quarantined.
+void INA226Array::_fault(uint8_t index)
+{
+  _faults++;
+  if (_failures[index] < 255) _failures[index]++;
+  uint32_t backoff = INA226_ARRAY_MAX_BACKOFF_US;
+  if ((_failures[index] < INA226_ARRAY_QUARANTINE) && (_failures[index] < 14))
+  {
+    backoff = (uint32_t)INA226_ARRAY_MIN_RETRY_US << _failures[index];
+  }
+  _due[index] = micros() + backoff;
+}
+
+
+//  -- END OF FILE --
+
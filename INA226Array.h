@@ -0,0 +1,107 @@
+#pragma once
+//    FILE: INA226Array.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - multi device scheduler
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Schedules the reads of multiple INA226 devices round robin,
+//  based upon their configured conversion period, so the reads
+//  of one device overlap with the conversions of the others.
+//  A faulty device is retried with an exponential backoff and
+//  quarantined after repeated faults, the other devices keep their rate.
+
+
+#include "INA226.h"
+
+
+#ifndef INA226_ARRAY_MAX_DEVICES
+#define INA226_ARRAY_MAX_DEVICES          16
+#endif
+
+//  consecutive faults before a device is quarantined.
+#ifndef INA226_ARRAY_QUARANTINE
+#define INA226_ARRAY_QUARANTINE           8
+#endif
+
+
+//  called by update() when a device has a new conversion.
+typedef void (*INA226Array_callback)(uint8_t index, INA226 * ina);
+
+
+class INA226Array
+{
+public:
+  INA226Array();
+
+  //  add an INA226 that is already initialized with begin().
+  //  returns false if the array is full.
+  bool     add(INA226 * ina);
+  uint8_t  count()                 { return _count; };
+  INA226 * get(uint8_t index);
+
+  //  scan 0x40..0x4F on wire, add every device with the INA226 IDs.
+  //  pool provides the objects, they get the address found.
+  //  calls begin() per device, so the cache matches the device.
+  //  call once per I2C bus, returns the number of devices added.
+  uint8_t  discover(INA226 * pool, uint8_t size, TwoWire * wire = &Wire);
+  //  copy the calibration and configuration of profile to all devices,
+  //  4 writes per device. Returns false if one or more failed.
+  bool     setProfile(const INA226 & profile);
+
+  //  start the conversions of all devices.
+  bool     begin();
+  //  call as often as possible, returns the number of devices
+  //  that had a new conversion in this call.
+  uint8_t  update();
+  void     setCallback(INA226Array_callback callback) { _callback = callback; };
+
+  //  synchronized acquisition, time aligned frames.
+  //  all devices are (re)started by back to back CONFIGURATION writes.
+  //  the I2C general call is not used, the INA226 only supports a
+  //  general call reset, which would clear the calibration.
+  bool     trigger();
+  //  time between the first and the last trigger write.
+  uint32_t getTriggerSkew_us()     { return _skew; };
+  uint32_t getTriggerTime(uint8_t index);
+  //  waits for the conversions of all devices and reads them,
+  //  frame[i] = device i, timestamp = trigger time of the device.
+  bool     readFrame(INA226Sample * frame, uint32_t timeout = INA226_MAX_WAIT_MS);
+  //  trigger() + readFrame()
+  bool     acquireFrame(INA226Sample * frame, uint32_t timeout = INA226_MAX_WAIT_MS);
+
+  //  aggregate throughput, since begin() or resetStatistics().
+  uint32_t getSampleCount()        { return _samples; };
+  float    getSamplesPerSecond();
+  void     resetStatistics();
+
+  //  fault handling, a faulty device is recovered with INA226::recover().
+  uint8_t  getFailures(uint8_t index);
+  bool     isQuarantined(uint8_t index);
+  uint32_t getFaultCount()         { return _faults; };
+  uint32_t getRecoveryCount()      { return _recoveries; };
+
+
+private:
+  INA226 * _devices[INA226_ARRAY_MAX_DEVICES];
+  uint32_t _due[INA226_ARRAY_MAX_DEVICES];   //  micros, expected ready
+  uint8_t  _failures[INA226_ARRAY_MAX_DEVICES];   //  consecutive
+  uint32_t _triggerTime[INA226_ARRAY_MAX_DEVICES];
+  uint32_t _skew;
+  uint8_t  _count;
+  uint8_t  _next;                             //  round robin start
+
+  void     _fault(uint8_t index);
+  uint32_t _faults;
+  uint32_t _recoveries;
+
+  INA226Array_callback _callback;
+
+  uint32_t _samples;
+  uint32_t _start;
+};
+
+
+//  -- END OF FILE --
+
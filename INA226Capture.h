@@ -0,0 +1,243 @@
+#pragma once
+//    FILE: INA226Capture.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - transient capture
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Oscilloscope like capture of raw shunt samples for inrush and fault
+//  analysis. Shunt only continuous mode, 140 us, 1 sample.
+//  Only the SHUNT_VOLTAGE register is read, the cached register pointer
+//  makes every read a single 2 byte transaction. No float math per sample.
+//
+//  A circular buffer holds the pre-trigger samples, after the trigger
+//  POST samples are recorded and the buffer is frozen for readout.
+//
+//  By default samples are read on the interval, not tied to the
+//  conversions, so a conversion can be read twice or be skipped.
+//  setConversionSync(true) reads a sample only after the conversion
+//  ready flag is set, at the cost of a MASK_ENABLE read per sample.
+
+
+#include "INA226.h"
+
+
+//  trigger types
+#define INA226_TRIGGER_RISING             0
+#define INA226_TRIGGER_FALLING            1
+#define INA226_TRIGGER_SLOPE              2
+
+//  states
+#define INA226_CAPTURE_IDLE               0
+#define INA226_CAPTURE_ARMED              1
+#define INA226_CAPTURE_TRIGGERED          2
+#define INA226_CAPTURE_DONE               3
+
+
+template <uint16_t N>
+class INA226Capture
+{
+  static_assert(N >= 2, "INA226Capture: N must be >= 2");
+
+public:
+  explicit INA226Capture(INA226 * ina)
+  {
+    _ina      = ina;
+    _type     = INA226_TRIGGER_RISING;
+    _level    = 0;
+    _post     = N / 2;
+    _interval = 0;
+    _state    = INA226_CAPTURE_IDLE;
+    _head     = 0;
+    _written  = 0;
+    _total    = 0;
+    _remaining = 0;
+    _sync     = false;
+  }
+
+
+  //  shunt only continuous, 140 us, 1 sample, one CONFIGURATION write.
+  //  samples are read every conversion period.
+  bool begin()
+  {
+    _ina->beginConfig();
+    _ina->setAverage(INA226_1_SAMPLE);
+    _ina->setShuntVoltageConversionTime(INA226_140_us);
+    _ina->setMode(5);
+    if (! _ina->commitConfig()) return false;
+    _interval = _ina->getConversionPeriod_us();
+    return true;
+  }
+
+
+  //  level in raw shunt units (2.5 uV), slope in raw units per sample.
+  //  RISING   previous < level <= sample
+  //  FALLING  previous > level >= sample
+  //  SLOPE    sample - previous >= level (level > 0) or <= level (level < 0)
+  void    setTrigger(uint8_t type, int16_t level)
+  {
+    _type  = type;
+    _level = level;
+  }
+  //  threshold in ampere, uses the shunt set by setMaxCurrentShunt().
+  //  the zero offset is applied to levels, not to a slope.
+  bool    setTriggerCurrent(float ampere, uint8_t type = INA226_TRIGGER_RISING)
+  {
+    float shunt = _ina->getShunt();
+    if (shunt <= 0) return false;
+    //  current = shunt voltage / shunt - zero offset
+    if (type != INA226_TRIGGER_SLOPE) ampere += _ina->getCurrentZeroOffset();
+    float raw = round(ampere * shunt / 2.5e-6);
+    if ((raw < -32768) || (raw > 32767)) return false;
+    setTrigger(type, raw);
+    return true;
+  }
+  uint8_t getTriggerType()         { return _type; };
+  int16_t getTriggerLevel()        { return _level; };
+
+  //  samples recorded after the trigger, including the trigger sample.
+  //  pre-trigger samples = N - post.
+  void    setPostTrigger(uint16_t post) { _post = (post == 0) ? 1 : ((post > N) ? N : post); };
+  uint16_t getPostTrigger()        { return _post; };
+  //  read interval in micros, 0 = back to back at the maximum I2C rate.
+  void    setInterval(uint32_t interval) { _interval = interval; };
+  uint32_t getInterval()           { return _interval; };
+  //  read a sample only after a new conversion, the interval is not used.
+  void    setConversionSync(bool sync) { _sync = sync; };
+  bool    getConversionSync()      { return _sync; };
+
+
+  //  start a new capture.
+  void    arm()
+  {
+    _head     = 0;
+    _written  = 0;
+    _total    = 0;
+    _state    = INA226_CAPTURE_ARMED;
+    _due      = micros();
+  }
+  //  force the trigger, e.g. timeout.
+  void    trigger()
+  {
+    if (_state != INA226_CAPTURE_ARMED) return;
+    _state       = INA226_CAPTURE_TRIGGERED;
+    _triggerTime = micros();
+    _remaining   = _post;
+  }
+
+
+  //  call as often as possible, returns true if a sample is read.
+  bool    update()
+  {
+    if ((_state != INA226_CAPTURE_ARMED) && (_state != INA226_CAPTURE_TRIGGERED)) return false;
+    uint32_t now = micros();
+    if (_sync)
+    {
+      //  one MASK_ENABLE read, clears the conversion ready flag.
+      if (! _ina->isConversionReady()) return false;
+    }
+    else if (_interval > 0)
+    {
+      if ((int32_t)(now - _due) < 0) return false;
+      _due += _interval;
+      //  too far behind, do not burst.
+      if ((int32_t)(now - _due) >= 0) _due = now + _interval;
+    }
+    int16_t sample = _ina->getShuntVoltageRaw();
+    if (! _ina->isValid()) return false;
+
+    int16_t previous = _buffer[(_head == 0) ? (N - 1) : (_head - 1)];
+    _buffer[_head] = sample;
+    _head++;
+    if (_head == N) _head = 0;
+    if (_written < N) _written++;
+    if (_total == 0) _firstTime = now;
+    _total++;
+
+    //  trigger only with a complete pre-trigger window.
+    bool complete = (_written > N - _post) && (_total > 1);
+    if ((_state == INA226_CAPTURE_ARMED) && complete && _triggered(previous, sample))
+    {
+      _state       = INA226_CAPTURE_TRIGGERED;
+      _triggerTime = now;
+      _remaining   = _post;
+    }
+    if (_state == INA226_CAPTURE_TRIGGERED)
+    {
+      _remaining--;
+      if (_remaining == 0)
+      {
+        _state   = INA226_CAPTURE_DONE;
+        _endTime = now;
+      }
+    }
+    return true;
+  }
+
+
+  uint8_t  getState()              { return _state; };
+  bool     isDone()                { return _state == INA226_CAPTURE_DONE; };
+
+
+  //  READOUT, valid when isDone(), oldest sample first.
+  uint16_t count()                 { return _written; };
+  uint16_t capacity()              { return N; };
+  int16_t  get(uint16_t index)
+  {
+    if (index >= _written) return 0;
+    uint16_t i = (_written < N) ? index : (_head + index);
+    if (i >= N) i -= N;
+    return _buffer[i];
+  }
+  //  index of the trigger sample.
+  uint16_t getTriggerIndex()       { return _written - _post; };
+  uint32_t getTriggerTime()        { return _triggerTime; };
+  //  average time between samples in micros.
+  float    getSamplePeriod_us()
+  {
+    if ((_state != INA226_CAPTURE_DONE) || (_total < 2)) return 0;
+    return (float)(_endTime - _firstTime) / (_total - 1);
+  }
+
+
+private:
+  bool _triggered(int16_t previous, int16_t sample)
+  {
+    switch (_type)
+    {
+      case INA226_TRIGGER_RISING:
+        return (previous < _level) && (sample >= _level);
+      case INA226_TRIGGER_FALLING:
+        return (previous > _level) && (sample <= _level);
+      case INA226_TRIGGER_SLOPE:
+      {
+        int32_t delta = (int32_t)sample - previous;
+        if (_level >= 0) return delta >= _level;
+        return delta <= _level;
+      }
+    }
+    return false;
+  }
+
+  INA226 * _ina;
+  int16_t  _buffer[N];
+  uint16_t _head;
+  uint16_t _written;
+  uint16_t _post;
+  uint16_t _remaining;
+  uint8_t  _type;
+  int16_t  _level;
+  uint8_t  _state;
+  uint32_t _interval;
+  uint32_t _due;
+  uint32_t _firstTime;
+  uint32_t _triggerTime;
+  uint32_t _endTime;
+  uint32_t _total;
+  bool     _sync;
+};
+
+
+//  -- END OF FILE --
+
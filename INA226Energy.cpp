@@ -0,0 +1,96 @@
+//    FILE: INA226Energy.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - energy and charge accumulator
+//     URL: https://github.com/RobTillaart/INA226
+
+
+#include "INA226Energy.h"
+
+
+INA226Energy::INA226Energy(INA226 * ina)
+{
+  _ina = ina;
+  reset();
+}
+
+
+bool INA226Energy::update()
+{
+  if (! _ina->poll()) return false;
+  INA226Sample sample;
+  if (! _ina->readSample(sample)) return false;
+  add(sample);
+  return true;
+}
+
+
+void INA226Energy::add(const INA226Sample & sample)
+{
+  if (_first)
+  {
+    _first = false;
+    _lastTimestamp = sample.timestamp;
+    return;
+  }
+  //  the conversion is the average over the elapsed interval.
+  uint32_t interval = sample.timestamp - _lastTimestamp;
+  _lastTimestamp = sample.timestamp;
+  _charge   += (int64_t)sample.current * interval;
+  _energy   += (uint64_t)sample.power * interval;
+  _duration += interval;
+  _samples++;
+}
+
+
+void INA226Energy::reset()
+{
+  _charge        = 0;
+  _energy        = 0;
+  _duration      = 0;
+  _samples       = 0;
+  _lastTimestamp = 0;
+  _first         = true;
+}
+
+
+float INA226Energy::getWattHour()
+{
+  //  power LSB = 25 x current_LSB, 1 Wh = 3600e6 W us
+  return _energy * (_ina->getCurrentLSB() * 25 / 3600e6);
+}
+
+
+float INA226Energy::getAmpereHour()
+{
+  return getCoulomb() / 3600;
+}
+
+
+float INA226Energy::getCoulomb()
+{
+  //  see configure(), current = raw * current_LSB - zero_offset
+  float coulomb = _charge * (_ina->getCurrentLSB() * 1e-6);
+  return coulomb - _ina->getCurrentZeroOffset() * getSeconds();
+}
+
+
+float INA226Energy::getSeconds()
+{
+  return _duration * 1e-6;
+}
+
+
+void INA226Energy::snapshot(INA226EnergySnapshot & snap)
+{
+  snap.wattHour   = getWattHour();
+  snap.ampereHour = getAmpereHour();
+  snap.coulomb    = getCoulomb();
+  snap.seconds    = getSeconds();
+  snap.samples    = _samples;
+}
+
+
+//  -- END OF FILE --
+
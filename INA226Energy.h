@@ -0,0 +1,68 @@
+#pragma once
+//    FILE: INA226Energy.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - energy and charge accumulator
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Integrates power and current of every new conversion over the real
+//  elapsed time between samples. Accumulators are 64 bit integers in raw
+//  LSB x microseconds, so there is no float rounding drift over days.
+//  Conversion to Wh, Ah and Coulomb is only done when asked for.
+
+
+#include "INA226.h"
+
+
+struct INA226EnergySnapshot
+{
+  float    wattHour;
+  float    ampereHour;
+  float    coulomb;
+  float    seconds;          //  integrated time
+  uint32_t samples;
+};
+
+
+class INA226Energy
+{
+public:
+  explicit INA226Energy(INA226 * ina);
+
+  //  poll the device, integrates a new conversion if available.
+  //  returns true if a sample is read.
+  //  poll() consumes the ready flag, one update() per device,
+  //  other consumers of the same device use add().
+  bool     update();
+  //  integrate a sample, e.g. from INA226Sampler or serviceAlert().
+  //  the first sample after reset() only sets the start time.
+  void     add(const INA226Sample & sample);
+  void     reset();
+
+  float    getWattHour();
+  float    getAmpereHour();
+  float    getCoulomb();
+  float    getSeconds();
+  uint32_t getSampleCount()        { return _samples; };
+  void     snapshot(INA226EnergySnapshot & snap);
+
+  //  raw accumulators, LSB x microseconds
+  int64_t  getChargeRaw()          { return _charge; };
+  uint64_t getEnergyRaw()          { return _energy; };
+
+
+private:
+  INA226 * _ina;
+
+  int64_t  _charge;         //  current LSB x us
+  uint64_t _energy;         //  power LSB x us
+  uint64_t _duration;       //  us
+  uint32_t _samples;
+  uint32_t _lastTimestamp;
+  bool     _first;
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,131 @@
+#pragma once
+//    FILE: INA226Filter.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - integer decimation filters
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Filters raw int16_t register values (shunt, bus, current) with integer
+//  math only, beyond the hardware averaging of 1024 samples.
+//  Output is decimated, one value per decimation input samples.
+
+
+#include "Arduino.h"
+
+
+//  filter types
+//  BOXCAR       moving average over the last LENGTH samples.
+//  EXPONENTIAL  y += (x - y) / 2^LENGTH, LENGTH = 1..15
+//  DECIMATE     block average of LENGTH samples (CIC order 1),
+//               one output per LENGTH samples.
+#define INA226_FILTER_BOXCAR              0
+#define INA226_FILTER_EXPONENTIAL         1
+#define INA226_FILTER_DECIMATE            2
+
+
+template <uint8_t TYPE, uint16_t LENGTH>
+class INA226Filter
+{
+  static_assert(TYPE <= INA226_FILTER_DECIMATE, "INA226Filter: unknown filter type");
+  static_assert(LENGTH > 0, "INA226Filter: LENGTH must be > 0");
+  static_assert((TYPE != INA226_FILTER_EXPONENTIAL) || (LENGTH <= 15),
+                "INA226Filter: EXPONENTIAL LENGTH must be <= 15");
+
+public:
+  //  decimation is ignored by DECIMATE, it uses LENGTH.
+  explicit INA226Filter(uint16_t decimation = 1)
+  {
+    setDecimation(decimation);
+    reset();
+  }
+
+
+  //  returns true if a new output value is available.
+  bool add(int16_t raw)
+  {
+    switch (TYPE)
+    {
+      case INA226_FILTER_BOXCAR:
+        _sum -= _buffer[_index];
+        _buffer[_index] = raw;
+        _sum += raw;
+        _index++;
+        if (_index == LENGTH) _index = 0;
+        if (_count < LENGTH) _count++;
+        break;
+      case INA226_FILTER_EXPONENTIAL:
+        if (_count == 0)
+        {
+          _sum = (int32_t)raw << LENGTH;    //  start at first value
+          _count = 1;
+        }
+        else
+        {
+          _sum += raw - (_sum >> LENGTH);
+        }
+        break;
+      case INA226_FILTER_DECIMATE:
+        _sum += raw;
+        _count++;
+        if (_count < LENGTH) return false;
+        _value = _divide(_sum, LENGTH);
+        _sum   = 0;
+        _count = 0;
+        return true;
+    }
+
+    _phase++;
+    if (_phase < _decimation) return false;
+    _phase = 0;
+    if (TYPE == INA226_FILTER_BOXCAR) _value = _divide(_sum, _count);
+    else                              _value = _sum >> LENGTH;
+    return true;
+  }
+
+
+  //  last output value, raw units.
+  int16_t  get()                   { return _value; };
+
+
+  void reset()
+  {
+    for (uint16_t i = 0; i < sizeof(_buffer) / sizeof(_buffer[0]); i++)
+    {
+      _buffer[i] = 0;
+    }
+    _sum   = 0;
+    _count = 0;
+    _index = 0;
+    _phase = 0;
+    _value = 0;
+  }
+
+
+  void     setDecimation(uint16_t decimation) { _decimation = (decimation == 0) ? 1 : decimation; };
+  uint16_t getDecimation()         { return (TYPE == INA226_FILTER_DECIMATE) ? LENGTH : _decimation; };
+  uint16_t getLength()             { return LENGTH; };
+  uint8_t  getType()               { return TYPE; };
+
+
+private:
+  //  only the BOXCAR needs the history.
+  int16_t  _buffer[(TYPE == INA226_FILTER_BOXCAR) ? LENGTH : 1];
+  int32_t  _sum;
+  uint16_t _count;
+  uint16_t _index;
+  uint16_t _phase;
+  uint16_t _decimation;
+  int16_t  _value;
+
+  //  rounded division
+  int16_t _divide(int32_t sum, uint16_t n)
+  {
+    if (sum >= 0) return (sum + n / 2) / n;
+    return (sum - n / 2) / n;
+  }
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,97 @@
+#pragma once
+//    FILE: INA226Fixed.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - compile time calibration
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  For a fixed shunt and maximum current (e.g. per board revision) the
+//  current_LSB, the CALIBRATION register and the integer scale factors
+//  are calculated by the compiler. No float calibration math in flash.
+//  Invalid combinations are rejected by static_assert.
+
+
+#include "INA226.h"
+
+
+//  compile time helpers, C++11 constexpr.
+static constexpr uint64_t INA226_ceil(uint64_t a, uint64_t b)  { return (a + b - 1) / b; }
+static constexpr uint64_t INA226_round(uint64_t a, uint64_t b) { return (a + b / 2) / b; }
+static constexpr uint64_t INA226_max(uint64_t a, uint64_t b)   { return (a > b) ? a : b; }
+//  largest shift <= 30 that keeps (a << shift) / b within 16 bit.
+static constexpr int8_t INA226_shift(uint64_t a, uint64_t b, int8_t shift = 0)
+{
+  return ((shift < 30) && (INA226_round(a << (shift + 1), b) <= 65535)) ? INA226_shift(a, b, shift + 1) : shift;
+}
+
+
+template <uint32_t SHUNT_MICRO_OHM, uint32_t MAX_CURRENT_MA>
+class INA226Fixed : public INA226
+{
+public:
+  //  datasheet: CAL = 0.00512 / (current_LSB * shunt)
+  //                 = 5.12e12 / (current_LSB_nA * shunt_uOhm)
+  //  current_LSB_nA = max(maxCurrent / 32768, CAL <= 32767)
+  static constexpr uint32_t CURRENT_LSB_NA = INA226_max(
+      INA226_ceil(MAX_CURRENT_MA * 1000000ULL, 32768),
+      INA226_ceil(5120000000000ULL, 32767ULL * SHUNT_MICRO_OHM));
+  static constexpr uint16_t CALIBRATION = INA226_round(
+      5120000000000ULL, (uint64_t)CURRENT_LSB_NA * SHUNT_MICRO_OHM);
+
+  static_assert(SHUNT_MICRO_OHM >= 1000,
+                "INA226Fixed: shunt < INA226_MINIMAL_SHUNT_OHM");
+  static_assert(MAX_CURRENT_MA >= 1,
+                "INA226Fixed: maxCurrent < 0.001 A");
+  //  81.90 mV, see setMaxCurrentShunt(), mA x uOhm = nV
+  static_assert((uint64_t)MAX_CURRENT_MA * SHUNT_MICRO_OHM <= 81900000ULL,
+                "INA226Fixed: shunt voltage > 81.90 mV");
+  static_assert((CALIBRATION > 0) && (CALIBRATION <= 32767),
+                "INA226Fixed: CALIBRATION out of range");
+
+  //  integer scaling, see convertCurrent_uA() and convertPower_uW()
+  static constexpr int8_t   CURRENT_SHIFT = INA226_shift(CURRENT_LSB_NA, 1000);
+  static constexpr uint16_t CURRENT_MUL   = INA226_round((uint64_t)CURRENT_LSB_NA << CURRENT_SHIFT, 1000);
+  static constexpr int8_t   POWER_SHIFT   = INA226_shift(25ULL * CURRENT_LSB_NA, 1000);
+  static constexpr uint16_t POWER_MUL     = INA226_round((25ULL * CURRENT_LSB_NA) << POWER_SHIFT, 1000);
+
+
+  explicit INA226Fixed(const uint8_t address, TwoWire *wire = &Wire) : INA226(address, wire)
+  {
+  }
+
+
+  //  writes the CALIBRATION register.
+  bool begin()
+  {
+    if (! INA226::begin()) return false;
+    return calibrate();
+  }
+
+
+  //  e.g. after reset(), like setMaxCurrentShunt() it disables auto range
+  //  and converts a typed alert limit again.
+  bool calibrate()
+  {
+    _autoRange     = false;
+    _range         = 0;
+    //  float members for the float API, constants only.
+    _current_LSB   = CURRENT_LSB_NA * 1e-9;
+    _shunt         = SHUNT_MICRO_OHM * 1e-6;
+    _maxCurrent    = CURRENT_LSB_NA * 32768e-9;
+    _current_mul   = CURRENT_MUL;
+    _current_shift = CURRENT_SHIFT;
+    _power_mul     = POWER_MUL;
+    _power_shift   = POWER_SHIFT;
+    if (! _writeCalibration(CALIBRATION)) return false;
+    //  float math only if a typed alert limit is set.
+    return _updateAlertLimit();
+  }
+
+
+  uint32_t getCurrentLSB_nA()      { return CURRENT_LSB_NA; };
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,126 @@
+#pragma once
+//    FILE: INA226Queue.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - lock free sample queue
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Single producer single consumer (SPSC) queue of INA226Sample.
+//  The producer (acquisition task / core) calls update() or push(),
+//  the consumer (application task / core) calls pop() or drain().
+//  No mutex, the two indices are only written by one side each and
+//  accessed with the gcc __atomic builtins (acquire / release).
+//
+//  The INA226 object itself is not thread safe, only the producer
+//  may access it (and the I2C bus) after the acquisition has started.
+//
+//  Note: intended for 32 bit dual core boards e.g. ESP32 and RP2040.
+//        On 8 bit AVR the 16 bit index access is not atomic.
+
+
+#include "INA226.h"
+
+
+template <uint16_t N>
+class INA226Queue
+{
+  static_assert((N >= 2) && ((N & (N - 1)) == 0), "INA226Queue: N must be a power of 2");
+  static_assert(N <= 32768, "INA226Queue: N too large");
+
+public:
+  INA226Queue()
+  {
+    _head    = 0;
+    _tail    = 0;
+    _dropped = 0;
+  }
+
+
+  ////////////////////////////////////////////////////
+  //
+  //  PRODUCER
+  //
+  //  poll the device, queue a new conversion if available.
+  //  returns true if a sample is queued.
+  //  poll() consumes the ready flag, one update() per device,
+  //  other consumers of the same device use push().
+  bool update(INA226 * ina)
+  {
+    if (! ina->poll()) return false;
+    INA226Sample sample;
+    if (! ina->readSample(sample)) return false;
+    return push(sample);
+  }
+
+
+  //  returns false if the queue is full, the sample is dropped.
+  bool push(const INA226Sample & sample)
+  {
+    uint16_t head = __atomic_load_n(&_head, __ATOMIC_RELAXED);
+    uint16_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    if ((uint16_t)(head - tail) == N)
+    {
+      __atomic_store_n(&_dropped, _dropped + 1, __ATOMIC_RELAXED);
+      return false;
+    }
+    _buffer[head & (N - 1)] = sample;
+    //  publish the sample before the new head.
+    __atomic_store_n(&_head, (uint16_t)(head + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+
+  ////////////////////////////////////////////////////
+  //
+  //  CONSUMER
+  //
+  //  oldest sample first.
+  bool pop(INA226Sample & sample)
+  {
+    uint16_t tail = __atomic_load_n(&_tail, __ATOMIC_RELAXED);
+    uint16_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    if (head == tail) return false;
+    sample = _buffer[tail & (N - 1)];
+    //  release the slot after it is copied.
+    __atomic_store_n(&_tail, (uint16_t)(tail + 1), __ATOMIC_RELEASE);
+    return true;
+  }
+
+
+  //  move up to size samples into buffer, returns number moved.
+  uint16_t drain(INA226Sample * buffer, uint16_t size)
+  {
+    uint16_t n = 0;
+    while ((n < size) && pop(buffer[n])) n++;
+    return n;
+  }
+
+
+  ////////////////////////////////////////////////////
+  //
+  //  BOTH SIDES, snapshot values
+  //
+  uint16_t count()
+  {
+    uint16_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    uint16_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    return head - tail;
+  }
+  uint16_t capacity()              { return N; };
+  bool     isEmpty()               { return count() == 0; };
+  bool     isFull()                { return count() == N; };
+  //  samples dropped because the queue was full.
+  uint32_t getDropped()            { return __atomic_load_n(&_dropped, __ATOMIC_RELAXED); };
+
+
+private:
+  INA226Sample _buffer[N];
+  uint16_t     _head;      //  written by producer only
+  uint16_t     _tail;      //  written by consumer only
+  uint32_t     _dropped;   //  written by producer only
+};
+
+
+//  -- END OF FILE --
+
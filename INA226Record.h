@@ -0,0 +1,227 @@
+#pragma once
+//    FILE: INA226Record.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - packed binary record
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Compact binary record for streaming raw samples over UART or to SD.
+//  Depends only on stdint.h so the decoder can be used on the host (PC).
+//
+//  RECORD LAYOUT (little endian, 14 bytes, 16 with absolute timestamp)
+//  offsets for a record with a delta timestamp.
+//
+//  offset  size  field
+//     0     1    sync 0xA5
+//     1     1    flags (bits 7..4) | device (bits 3..0)
+//     2     1    sequence number, wraps
+//     3    2|4   timestamp, delta micros (16 bit) or absolute (32 bit)
+//     5     2    shunt      raw, int16_t
+//     7     2    bus        raw, uint16_t
+//     9     2    current    raw, int16_t
+//    11     2    power      raw, uint16_t
+//    13     1    checksum, sum of all previous bytes (mod 256)
+
+
+#include <stdint.h>
+
+
+#define INA226_RECORD_SYNC                0xA5
+#define INA226_RECORD_SIZE                14
+#define INA226_RECORD_MAX_SIZE            16
+//  absolute timestamp every N records for resynchronization, power of 2.
+#define INA226_RECORD_RESYNC              64
+
+//  flags
+#define INA226_RECORD_ABSOLUTE            0x10
+
+//  decode() return values
+#define INA226_RECORD_INCOMPLETE          0
+#define INA226_RECORD_INVALID             -1
+
+
+//  decoded record, raw register values.
+struct INA226Record
+{
+  uint8_t  device;
+  uint8_t  sequence;
+  uint32_t timestamp;   //  micros, absolute
+  int16_t  shunt;
+  uint16_t bus;
+  int16_t  current;
+  uint16_t power;
+};
+
+
+class INA226RecordEncoder
+{
+public:
+  INA226RecordEncoder()
+  {
+    reset();
+  }
+
+
+  //  writes one record into buffer, which must hold INA226_RECORD_MAX_SIZE bytes.
+  //  device = 0..15, e.g. address & 0x0F.
+  //  sample = INA226Sample or INA226Record, any struct with the same fields.
+  //  returns the number of bytes written.
+  template <class SAMPLE>
+  uint8_t encode(uint8_t * buffer, uint8_t device, const SAMPLE & sample)
+  {
+    uint32_t delta = sample.timestamp - _last;
+    uint8_t  flags = 0;
+    if (_first || (delta > 0xFFFF)) flags |= INA226_RECORD_ABSOLUTE;
+    //  periodic absolute record, a decoder that lost records can resync.
+    if ((_sequence & (INA226_RECORD_RESYNC - 1)) == 0) flags |= INA226_RECORD_ABSOLUTE;
+    _first = false;
+    _last  = sample.timestamp;
+
+    uint8_t n = 0;
+    buffer[n++] = INA226_RECORD_SYNC;
+    buffer[n++] = flags | (device & 0x0F);
+    buffer[n++] = _sequence++;
+    if (flags & INA226_RECORD_ABSOLUTE)
+    {
+      n = _put16(buffer, n, sample.timestamp & 0xFFFF);
+      n = _put16(buffer, n, sample.timestamp >> 16);
+    }
+    else
+    {
+      n = _put16(buffer, n, delta);
+    }
+    n = _put16(buffer, n, sample.shunt);
+    n = _put16(buffer, n, sample.bus);
+    n = _put16(buffer, n, sample.current);
+    n = _put16(buffer, n, sample.power);
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < n; i++) sum += buffer[i];
+    buffer[n++] = sum;
+    return n;
+  }
+
+
+  //  next record has an absolute timestamp, sequence restarts at 0.
+  void    reset()
+  {
+    _first    = true;
+    _last     = 0;
+    _sequence = 0;
+  }
+
+
+  uint8_t getSequence()            { return _sequence; };
+
+
+private:
+  uint8_t _put16(uint8_t * buffer, uint8_t n, uint16_t value)
+  {
+    buffer[n++] = value & 0xFF;
+    buffer[n++] = value >> 8;
+    return n;
+  }
+
+  bool     _first;
+  uint32_t _last;
+  uint8_t  _sequence;
+};
+
+
+class INA226RecordDecoder
+{
+public:
+  INA226RecordDecoder()
+  {
+    reset();
+  }
+
+
+  //  decodes one record from the start of buffer.
+  //  returns  > 0  number of bytes used, record is valid.
+  //           0    INA226_RECORD_INCOMPLETE, more bytes needed.
+  //          -1    INA226_RECORD_INVALID, skip one byte and retry (resync).
+  //  records with a delta timestamp need a preceding absolute record.
+  //  after a lost record delta records are invalid until the next
+  //  absolute record, otherwise all later timestamps would be shifted.
+  int16_t decode(const uint8_t * buffer, uint16_t length, INA226Record & record)
+  {
+    if (length < 1) return INA226_RECORD_INCOMPLETE;
+    if (buffer[0] != INA226_RECORD_SYNC) return INA226_RECORD_INVALID;
+    if (length < 2) return INA226_RECORD_INCOMPLETE;
+    bool absolute = (buffer[1] & INA226_RECORD_ABSOLUTE) != 0;
+    uint8_t size  = absolute ? INA226_RECORD_MAX_SIZE : INA226_RECORD_SIZE;
+    if (length < size) return INA226_RECORD_INCOMPLETE;
+
+    uint8_t sum = 0;
+    for (uint8_t i = 0; i < size - 1; i++) sum += buffer[i];
+    if (sum != buffer[size - 1]) return INA226_RECORD_INVALID;
+    if ((buffer[1] & 0xE0) != 0) return INA226_RECORD_INVALID;  //  unknown flags
+    if (!absolute && !_synced) return INA226_RECORD_INVALID;
+    uint8_t sequence = buffer[2];
+    if (!absolute && (sequence != (uint8_t)(_sequence + 1)))
+    {
+      //  lost record(s), counted at the next absolute record.
+      _synced = false;
+      return INA226_RECORD_INVALID;
+    }
+
+    uint8_t n = 3;
+    if (absolute)
+    {
+      _last  = _get16(buffer, n);
+      _last |= (uint32_t)_get16(buffer, n + 2) << 16;
+      n += 4;
+    }
+    else
+    {
+      _last += _get16(buffer, n);
+      n += 2;
+    }
+    if (_started) _lost += (uint8_t)(sequence - _sequence - 1);
+    _sequence = sequence;
+    _synced   = true;
+    _started  = true;
+
+    record.device    = buffer[1] & 0x0F;
+    record.sequence  = sequence;
+    record.timestamp = _last;
+    record.shunt     = (int16_t)_get16(buffer, n);
+    record.bus       = _get16(buffer, n + 2);
+    record.current   = (int16_t)_get16(buffer, n + 4);
+    record.power     = _get16(buffer, n + 6);
+    return size;
+  }
+
+
+  void     reset()
+  {
+    _synced   = false;
+    _started  = false;
+    _last     = 0;
+    _sequence = 0;
+    _lost     = 0;
+  }
+
+
+  //  number of records missing or skipped, based upon the sequence numbers.
+  //  counted per resync modulo 256.
+  uint32_t getLost()               { return _lost; };
+
+
+private:
+  uint16_t _get16(const uint8_t * buffer, uint8_t n)
+  {
+    return buffer[n] | (buffer[n + 1] << 8);
+  }
+
+  bool     _synced;      //  timestamp base valid
+  bool     _started;     //  sequence valid
+  uint32_t _last;
+  uint8_t  _sequence;
+  uint32_t _lost;
+};
+
+
+//  -- END OF FILE --
+
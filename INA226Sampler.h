@@ -0,0 +1,127 @@
+#pragma once
+//    FILE: INA226Sampler.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - sample ring buffer
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Fixed capacity ring buffer of INA226Sample, no dynamic allocation.
+//  Decouples high rate acquisition from slow consumers (Serial, SD, radio).
+
+
+#include "INA226.h"
+
+
+//  policy when the buffer is full
+#define INA226_OVERWRITE_OLDEST           0
+#define INA226_DROP_NEWEST                1
+
+
+template <uint16_t N>
+class INA226Sampler
+{
+public:
+  explicit INA226Sampler(INA226 * ina, uint8_t policy = INA226_OVERWRITE_OLDEST)
+  {
+    _ina    = ina;
+    _policy = policy;
+    clear();
+  }
+
+
+  //  poll the device, store a new conversion if available.
+  //  returns true if a sample is read.
+  //  poll() consumes the ready flag, one update() per device,
+  //  other consumers of the same device use push().
+  bool update()
+  {
+    if (! _ina->poll()) return false;
+    INA226Sample sample;
+    if (! _ina->readSample(sample)) return false;
+    push(sample);
+    return true;
+  }
+
+
+  //  returns false if the sample is dropped.
+  bool push(const INA226Sample & sample)
+  {
+    if (_count == N)
+    {
+      _dropped++;
+      if (_policy == INA226_DROP_NEWEST) return false;
+      //  overwrite oldest
+      _tail++;
+      if (_tail == N) _tail = 0;
+      _count--;
+    }
+    _buffer[_head] = sample;
+    _head++;
+    if (_head == N) _head = 0;
+    _count++;
+    return true;
+  }
+
+
+  //  oldest sample first.
+  bool pop(INA226Sample & sample)
+  {
+    if (_count == 0) return false;
+    sample = _buffer[_tail];
+    _tail++;
+    if (_tail == N) _tail = 0;
+    _count--;
+    return true;
+  }
+
+
+  bool peek(INA226Sample & sample)
+  {
+    if (_count == 0) return false;
+    sample = _buffer[_tail];
+    return true;
+  }
+
+
+  //  move up to size samples into buffer, returns number moved.
+  uint16_t drain(INA226Sample * buffer, uint16_t size)
+  {
+    uint16_t n = 0;
+    while ((n < size) && pop(buffer[n])) n++;
+    return n;
+  }
+
+
+  void clear()
+  {
+    _head    = 0;
+    _tail    = 0;
+    _count   = 0;
+    _dropped = 0;
+  }
+
+
+  uint16_t count()                    { return _count; };
+  uint16_t capacity()                 { return N; };
+  bool     isEmpty()                  { return _count == 0; };
+  bool     isFull()                   { return _count == N; };
+  //  samples dropped or overwritten since clear().
+  uint32_t getDropped()               { return _dropped; };
+  void     setPolicy(uint8_t policy)  { _policy = policy; };
+  uint8_t  getPolicy()                { return _policy; };
+
+
+private:
+  INA226 *     _ina;
+  INA226Sample _buffer[N];
+  uint16_t     _head;
+  uint16_t     _tail;
+  uint16_t     _count;
+  uint32_t     _dropped;
+  uint8_t      _policy;
+};
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,111 @@
+//    FILE: INA226Statistics.cpp
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - streaming statistics
+//     URL: https://github.com/RobTillaart/INA226
+
+
+#include "INA226Statistics.h"
+
+
+////////////////////////////////////////////////////////
+//
+//  INA226Stat
+//
+void INA226Stat::reset()
+{
+  _count = 0;
+  _min   = 0;
+  _max   = 0;
+  _shift = 0;
+  _sum   = 0;
+  _sumSq = 0;
+}
+
+
+void INA226Stat::add(int32_t value)
+{
+  if (_count == 0)
+  {
+    _shift = value;
+    _min   = value;
+    _max   = value;
+  }
+  if (value < _min) _min = value;
+  if (value > _max) _max = value;
+  int32_t delta = value - _shift;
+  _sum   += delta;
+  _sumSq += (uint64_t)((int64_t)delta * delta);
+  _count++;
+}
+
+
+float INA226Stat::mean()
+{
+  if (_count == 0) return 0;
+  return _shift + (float)_sum / _count;
+}
+
+
+float INA226Stat::variance()
+{
+  if (_count < 2) return 0;
+  //  M2 = sumSq - sum^2 / n, with |sum| = q x n + r
+  //     = sumSq - n x q^2 - 2 x q x r - r^2 / n
+  //  the integer part is exact in 64 bit, no cancellation in float
+  //  when the mean drifts away from the first sample.
+  uint64_t sum = (_sum < 0) ? -_sum : _sum;
+  uint64_t q   = sum / _count;
+  uint64_t r   = sum % _count;
+  uint64_t m2  = _sumSq - _count * q * q - 2 * q * r;
+  return ((float)m2 - (float)r * r / _count) / (_count - 1);
+}
+
+
+float INA226Stat::stddev()
+{
+  return sqrt(variance());
+}
+
+
+////////////////////////////////////////////////////////
+//
+//  INA226Statistics
+//
+INA226Statistics::INA226Statistics(INA226 * ina)
+{
+  _ina = ina;
+}
+
+
+bool INA226Statistics::update()
+{
+  if (! _ina->poll()) return false;
+  INA226Sample sample;
+  if (! _ina->readSample(sample)) return false;
+  add(sample);
+  return true;
+}
+
+
+void INA226Statistics::add(const INA226Sample & sample)
+{
+  shunt.add(sample.shunt);
+  bus.add(sample.bus);
+  current.add(sample.current);
+  power.add(sample.power);
+}
+
+
+void INA226Statistics::reset()
+{
+  shunt.reset();
+  bus.reset();
+  current.reset();
+  power.reset();
+}
+
+
+//  -- END OF FILE --
+
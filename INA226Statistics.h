@@ -0,0 +1,69 @@
+#pragma once
+//    FILE: INA226Statistics.h
+//  AUTHOR: Rob Tillaart
+// VERSION: 0.7.0
+//    DATE: 2026-10-17
+// PURPOSE: Arduino library for INA226 power sensor - streaming statistics
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Running minimum, maximum, mean and variance in raw register units.
+//  Constant RAM per channel, integer math per sample.
+//  The sums are taken relative to the first sample (shifted data) and
+//  are exact in 64 bit. variance() does the subtraction in 64 bit integer
+//  math too, only the (small) result is converted to float.
+
+
+#include "INA226.h"
+
+
+class INA226Stat
+{
+public:
+  INA226Stat()                     { reset(); };
+
+  void     reset();
+  void     add(int32_t value);
+
+  uint32_t count()                 { return _count; };
+  int32_t  minimum()               { return _min; };
+  int32_t  maximum()               { return _max; };
+  float    mean();
+  float    variance();             //  sample variance, n - 1
+  float    stddev();
+
+private:
+  uint32_t _count;
+  int32_t  _min;
+  int32_t  _max;
+  int32_t  _shift;                 //  first sample
+  int64_t  _sum;                   //  sum (x - shift)
+  uint64_t _sumSq;                 //  sum (x - shift)^2
+};
+
+
+class INA226Statistics
+{
+public:
+  explicit INA226Statistics(INA226 * ina);
+
+  //  poll the device, add a new conversion if available.
+  //  returns true if a sample is read.
+  //  poll() consumes the ready flag, one update() per device,
+  //  other consumers of the same device use add().
+  bool     update();
+  void     add(const INA226Sample & sample);
+  void     reset();
+
+  //  per channel, raw units, see INA226Sample for the LSB's.
+  INA226Stat shunt;
+  INA226Stat bus;
+  INA226Stat current;
+  INA226Stat power;
+
+private:
+  INA226 * _ina;
+};
+
+
+//  -- END OF FILE --
+
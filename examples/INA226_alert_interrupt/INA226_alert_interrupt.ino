@@ -0,0 +1,81 @@
+//
+//    FILE: INA226_alert_interrupt.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo ALERT pin interrupt driven sampling
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+//
+//  connect the ALERT pin of the INA226 to an interrupt pin,
+//  the ALERT pin is open drain so it needs a pull up.
+
+
+#include "INA226.h"
+
+
+#define ALERT_PIN     2
+
+
+INA226 INA(0x40);
+
+INA226Sample sample;
+uint32_t count = 0;
+
+
+void alertISR()
+{
+  INA.alertInterrupt();
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  Wire.setClock(400000);
+  if (!INA.begin() )
+  {
+    Serial.println("could not connect. Fix and Reboot");
+  }
+  INA.setMaxCurrentShunt(1, 0.002);
+
+  INA.beginConfig();
+  INA.setAverage(INA226_16_SAMPLES);
+  INA.setBusVoltageConversionTime(INA226_140_us);
+  INA.setShuntVoltageConversionTime(INA226_140_us);
+  INA.setModeShuntBusContinuous();
+  INA.commitConfig();
+
+  pinMode(ALERT_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(ALERT_PIN), alertISR, FALLING);
+  INA.enableConversionReadyAlert();
+}
+
+
+void loop()
+{
+  if (INA.serviceAlert(sample))
+  {
+    count++;
+  }
+
+  static uint32_t lastTime = 0;
+  if (millis() - lastTime >= 1000)
+  {
+    lastTime = millis();
+    Serial.print(count);
+    Serial.print("\t");
+    Serial.print(INA.convertBusVoltage_mV(sample.bus));
+    Serial.print("\t");
+    Serial.print(INA.convertCurrent_uA(sample.current));
+    Serial.println();
+    count = 0;
+  }
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,59 @@
+//
+//    FILE: INA226_array_frame.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo synchronized time aligned frames of multiple devices
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+
+
+#include "INA226Array.h"
+
+
+INA226 pool[16];
+INA226Array sensors;
+INA226Sample frame[16];
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  Wire.setClock(400000);
+
+  uint8_t found = sensors.discover(pool, 16, &Wire);
+  Serial.print("found:\t");
+  Serial.println(found);
+  if (found == 0) return;
+
+  INA226 * first = sensors.get(0);
+  first->setMaxCurrentShunt(1, 0.002);
+  first->beginConfig();
+  first->setAverage(INA226_16_SAMPLES);
+  first->setModeShuntBusTrigger();
+  first->commitConfig();
+  sensors.setProfile(*first);
+}
+
+
+void loop()
+{
+  if (sensors.acquireFrame(frame))
+  {
+    Serial.print(sensors.getTriggerSkew_us());
+    for (uint8_t i = 0; i < sensors.count(); i++)
+    {
+      Serial.print("\t");
+      Serial.print(sensors.get(i)->convertCurrent_uA(frame[i].current));
+    }
+    Serial.println();
+  }
+  delay(100);
+}
+
+
+//  -- END OF FILE --
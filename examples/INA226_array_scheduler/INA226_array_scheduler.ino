@@ -0,0 +1,87 @@
+//
+//    FILE: INA226_array_scheduler.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo INA226Array scheduler, adjust to your sensor count
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+
+
+#include "INA226Array.h"
+
+
+#define INA_COUNT  4
+
+INA226 INA[INA_COUNT] =
+{
+  INA226(0x40),
+  INA226(0x41),
+  INA226(0x42),
+  INA226(0x43)
+};
+
+INA226Array sensors;
+
+int16_t lastCurrent[INA_COUNT];
+
+
+void newSample(uint8_t index, INA226 * ina)
+{
+  //  keep the callback short, store raw value only.
+  lastCurrent[index] = ina->getCurrentRaw();
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  Wire.setClock(400000);
+  for (int ID = 0; ID < INA_COUNT; ID++)
+  {
+    if (!INA[ID].begin() )
+    {
+      Serial.print("Could not connect: ");
+      Serial.println(ID);
+      continue;
+    }
+    INA[ID].setMaxCurrentShunt(1, 0.002);
+    INA[ID].beginConfig();
+    INA[ID].setAverage(INA226_4_SAMPLES);
+    INA[ID].setBusVoltageConversionTime(INA226_588_us);
+    INA[ID].setShuntVoltageConversionTime(INA226_588_us);
+    INA[ID].setModeShuntBusContinuous();
+    INA[ID].commitConfig();
+    sensors.add(&INA[ID]);
+  }
+  sensors.setCallback(newSample);
+  sensors.begin();
+}
+
+
+void loop()
+{
+  sensors.update();
+
+  static uint32_t lastTime = 0;
+  if (millis() - lastTime >= 1000)
+  {
+    lastTime = millis();
+    Serial.print(sensors.getSamplesPerSecond(), 1);
+    Serial.print("\t");
+    for (int ID = 0; ID < sensors.count(); ID++)
+    {
+      Serial.print(sensors.get(ID)->convertCurrent_uA(lastCurrent[ID]));
+      Serial.print("\t");
+    }
+    Serial.println();
+    sensors.resetStatistics();
+  }
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,52 @@
+//
+//    FILE: INA226_binary_stream.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo streaming packed binary records over Serial
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+//
+//  14 bytes per sample instead of ~40 bytes of text.
+//  decode on the host with INA226RecordDecoder from INA226Record.h
+
+
+#include "INA226.h"
+#include "INA226Record.h"
+
+
+INA226 INA(0x40);
+INA226RecordEncoder encoder;
+
+uint8_t buffer[INA226_RECORD_MAX_SIZE];
+
+
+void setup()
+{
+  Serial.begin(500000);
+  //  no text output, the stream is binary.
+
+  Wire.begin();
+  Wire.setClock(400000);
+  if (!INA.begin())
+  {
+    while (1);
+  }
+  INA.setMaxCurrentShunt(1, 0.002);
+  //  ~ 1800 samples per second
+  INA.setSampleRate(1800);
+  INA.startConversion();
+}
+
+
+void loop()
+{
+  INA226Sample sample;
+  if (INA.poll() && INA.readSample(sample))
+  {
+    uint8_t length = encoder.encode(buffer, INA.getAddress() & 0x0F, sample);
+    Serial.write(buffer, length);
+  }
+}
+
+
+//  -- END OF FILE --
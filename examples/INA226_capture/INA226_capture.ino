@@ -0,0 +1,62 @@
+//
+//    FILE: INA226_capture.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo transient capture of an inrush current
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+
+
+#include "INA226.h"
+#include "INA226Capture.h"
+
+
+INA226 INA(0x40);
+INA226Capture<256> capture(&INA);
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  Wire.setClock(400000);
+  if (!INA.begin())
+  {
+    Serial.println("could not connect. Fix and Reboot");
+  }
+  INA.setMaxCurrentShunt(10, 0.002);
+
+  //  shunt only, 140 us, 1 sample
+  capture.begin();
+  //  trigger at 2 A rising, 64 pre-trigger samples.
+  capture.setTriggerCurrent(2.0, INA226_TRIGGER_RISING);
+  capture.setPostTrigger(192);
+  capture.arm();
+}
+
+
+void loop()
+{
+  capture.update();
+  if (capture.isDone())
+  {
+    Serial.print("period us:\t");
+    Serial.println(capture.getSamplePeriod_us());
+    uint16_t trig = capture.getTriggerIndex();
+    for (uint16_t i = 0; i < capture.count(); i++)
+    {
+      Serial.print((int)i - (int)trig);
+      Serial.print("\t");
+      Serial.println(INA.convertShuntVoltage_uV(capture.get(i)));
+    }
+    //  next capture
+    capture.arm();
+  }
+}
+
+
+//  -- END OF FILE --
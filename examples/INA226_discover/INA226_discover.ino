@@ -0,0 +1,73 @@
+//
+//    FILE: INA226_discover.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo discovery of all INA226 devices and a shared profile
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+
+
+#include "INA226Array.h"
+
+
+//  objects for up to 16 devices, addresses are set by discover()
+INA226 pool[16];
+INA226Array sensors;
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  Wire.setClock(400000);
+
+  uint32_t start = micros();
+  uint8_t found = sensors.discover(pool, 16, &Wire);
+  //  second bus, if available
+  //  found += sensors.discover(pool + found, 16 - found, &Wire1);
+
+  //  calibration math once, on the first device.
+  if (found > 0)
+  {
+    INA226 * first = sensors.get(0);
+    first->setMaxCurrentShunt(1, 0.002);
+    first->beginConfig();
+    first->setAverage(INA226_16_SAMPLES);
+    first->setModeShuntBusContinuous();
+    first->commitConfig();
+    sensors.setProfile(*first);
+  }
+  uint32_t duration = micros() - start;
+
+  Serial.print("found:\t");
+  Serial.println(found);
+  Serial.print("time:\t");
+  Serial.println(duration);
+  for (uint8_t i = 0; i < sensors.count(); i++)
+  {
+    Serial.print(i);
+    Serial.print("\t0x");
+    Serial.println(sensors.get(i)->getAddress(), HEX);
+  }
+}
+
+
+void loop()
+{
+  for (uint8_t i = 0; i < sensors.count(); i++)
+  {
+    Serial.print(sensors.get(i)->getBusVoltage(), 3);
+    Serial.print("\t");
+    Serial.print(sensors.get(i)->getCurrent_mA(), 3);
+    Serial.print("\t");
+  }
+  Serial.println();
+  delay(1000);
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,113 @@
+//
+//    FILE: INA226_dual_core.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo acquisition on one core, processing on the other
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+//
+//  ESP32   acquisition in a FreeRTOS task pinned to core 0.
+//  RP2040  acquisition in setup1() / loop1() on core 1.
+//  other   acquisition and processing both in loop().
+
+
+#include "INA226.h"
+#include "INA226Queue.h"
+
+
+INA226 INA(0x40);
+INA226Queue<64> queue;
+
+uint32_t count = 0;
+uint32_t lastTime = 0;
+
+//  RP2040 runs loop1() in parallel with setup(), wait until INA is configured.
+volatile bool ready = false;
+
+
+//  PRODUCER, the only code that uses INA and Wire after setup().
+void acquire()
+{
+  queue.update(&INA);
+}
+
+
+#if defined(ESP32)
+void acquisitionTask(void * parameter)
+{
+  (void) parameter;
+  while (true)
+  {
+    acquire();
+    vTaskDelay(1);
+  }
+}
+#endif
+
+
+#if defined(ARDUINO_ARCH_RP2040)
+void setup1()
+{
+}
+
+void loop1()
+{
+  if (ready) acquire();
+}
+#endif
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  if (!INA.begin())
+  {
+    Serial.println("could not connect. Fix and Reboot");
+  }
+  INA.setMaxCurrentShunt(1, 0.002);
+  INA.setSampleRate(500);
+  INA.startConversion();
+  ready = true;
+
+#if defined(ESP32)
+  xTaskCreatePinnedToCore(acquisitionTask, "INA226", 4096, NULL, 2, NULL, 0);
+#endif
+}
+
+
+void loop()
+{
+#if !defined(ESP32) && !defined(ARDUINO_ARCH_RP2040)
+  acquire();
+#endif
+
+  //  CONSUMER, uses only the queue, convert raw values.
+  INA226Sample sample;
+  while (queue.pop(sample))
+  {
+    count++;
+    if (count % 100 == 0)
+    {
+      Serial.print(sample.timestamp);
+      Serial.print("\t");
+      Serial.println(INA.convertCurrent_uA(sample.current));
+    }
+  }
+
+  if (millis() - lastTime >= 1000)
+  {
+    lastTime = millis();
+    Serial.print("samples: ");
+    Serial.print(count);
+    Serial.print("\tdropped: ");
+    Serial.println(queue.getDropped());
+  }
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,79 @@
+//
+//    FILE: INA226_non_blocking.ino
+//  AUTHOR: Rob Tillaart
+// PURPOSE: demo non blocking conversion with startConversion() and poll()
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  not tested with HW yet
+
+
+#include "INA226.h"
+
+
+INA226 INA0(0x40);
+INA226 INA1(0x41);
+
+uint32_t count = 0;
+uint32_t lastTime = 0;
+
+
+void printCurrent(INA226 * ina)
+{
+  Serial.print(ina->getAddress(), HEX);
+  Serial.print("\t");
+  Serial.println(ina->getCurrent_mA(), 3);
+}
+
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println(__FILE__);
+  Serial.print("INA226_LIB_VERSION: ");
+  Serial.println(INA226_LIB_VERSION);
+
+  Wire.begin();
+  if (!INA0.begin() || !INA1.begin())
+  {
+    Serial.println("could not connect. Fix and Reboot");
+  }
+  INA0.setMaxCurrentShunt(1, 0.002);
+  INA1.setMaxCurrentShunt(1, 0.002);
+
+  //  INA0 triggered, is restarted after every conversion.
+  INA0.setAverage(INA226_64_SAMPLES);
+  INA0.setModeShuntBusTrigger();
+  INA0.setConversionCallback(printCurrent);
+
+  //  INA1 continuous.
+  INA1.setAverage(INA226_16_SAMPLES);
+  INA1.setModeShuntBusContinuous();
+}
+
+
+void loop()
+{
+  //  returns immediately
+  if (INA0.poll())
+  {
+    INA0.startConversion();
+  }
+  if (INA1.poll())
+  {
+    Serial.print("INA1\t");
+    Serial.println(INA1.getBusVoltage(), 3);
+  }
+
+  //  other tasks are not blocked.
+  count++;
+  if (millis() - lastTime >= 1000)
+  {
+    lastTime = millis();
+    Serial.print("loops per second: ");
+    Serial.println(count);
+    count = 0;
+  }
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,543 @@
+#pragma once
+//
+//    FILE: INA226_emulator.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: register level INA226 emulator for host side unit tests and benchmarks.
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Models the register file, conversion timing (BVCT, SVCT, AVG, MODE),
+//  the CVRF and OVF flags, the alert function, latch and the ALERT pin.
+//  Signals are injected as constant values or as a waveform function.
+//
+//  It plugs in as TwoWire, so the Wire implementation used must have virtual
+//  transaction functions, e.g. the host core in test/emulator/host.
+//  The arduino_ci TwoWire mock has no virtual functions, so these tests
+//  are not in the arduino_ci test folder, see test/emulator/run_tests.sh.
+//
+//  Timing uses micros(). The host clock only advances with delay() and
+//  delayMicroseconds(), like arduino_ci, so the emulation is deterministic.
+
+
+#include "Arduino.h"
+#include "Wire.h"
+
+
+//  waveform: value at time t (micros since start of emulation).
+typedef float (*INA226_waveform)(uint32_t t);
+
+
+class INA226_emulator : public TwoWire
+{
+public:
+  explicit INA226_emulator(uint8_t address = 0x40)
+  {
+    _address   = address;
+    _connected = true;
+    _failNext  = 0;
+    _busTime   = 0;
+    _manufacturer = 0x5449;
+    _die       = 0x2260;
+    _shuntV    = 0;
+    _busV      = 0;
+    _shuntWave = NULL;
+    _busWave   = NULL;
+    _start     = micros();
+    _powerOnReset();
+  }
+
+
+  ////////////////////////////////////////////////////////
+  //
+  //  SIGNAL INJECTION
+  //
+  void     setShuntVoltage(float volt)         { _shuntV = volt; };
+  void     setBusVoltage(float volt)           { _busV = volt; };
+  void     setShuntWaveform(INA226_waveform w) { _shuntWave = w; };
+  void     setBusWaveform(INA226_waveform w)   { _busWave = w; };
+  //  simulate a device dropping off the bus (NACK).
+  void     setConnected(bool connected)        { _connected = connected; };
+  //  simulate transient errors, the next count transactions NACK.
+  void     failNext(uint8_t count)             { _failNext = count; };
+  //  simulate a slow bus, every transaction takes micros.
+  void     setTransactionTime(uint16_t us)      { _busTime = us; };
+  void     powerOnReset()                      { _powerOnReset(); };
+  //  simulate another device at the same address, e.g. INA219 / INA260.
+  void     setIdentity(uint16_t manufacturer, uint16_t die)
+  {
+    _manufacturer = manufacturer;
+    _die = die;
+  };
+
+
+  ////////////////////////////////////////////////////////
+  //
+  //  INSPECTION
+  //
+  uint16_t peekRegister(uint8_t reg)  { _update(); return _reg(reg); };
+  uint8_t  getPointer()               { return _pointer; };
+  uint8_t  getAddress()               { return _address; };
+  //  true when the alert is active, independent of APOL.
+  bool     alertAsserted()            { _update(); return _alert; };
+  //  level of the ALERT pin, active LOW, active HIGH if APOL is set.
+  uint8_t  alertPinLevel()
+  {
+    bool activeHigh = (_mask & 0x0002) != 0;
+    return (alertAsserted() == activeHigh) ? HIGH : LOW;
+  };
+  uint32_t getConversionCount()       { return _conversions; };
+  //  bus statistics.
+  uint32_t getWriteTransactions()     { return _writes; };
+  uint32_t getReadTransactions()      { return _reads; };
+  uint32_t getPointerWrites()         { return _pointerWrites; };
+  void     resetStatistics()          { _writes = _reads = _pointerWrites = 0; };
+
+  //  duration of one complete conversion cycle in micros.
+  uint32_t conversionPeriod()
+  {
+    static const uint16_t CT[8] = { 140, 204, 332, 588, 1100, 2100, 4200, 8300 };
+    static const uint16_t AVG[8] = { 1, 4, 16, 64, 128, 256, 512, 1024 };
+    uint8_t  mode = _config & 0x0007;
+    uint32_t t = 0;
+    if (mode & 0x01) t += CT[(_config >> 3) & 0x07];
+    if (mode & 0x02) t += CT[(_config >> 6) & 0x07];
+    return t * AVG[(_config >> 9) & 0x07];
+  }
+
+
+  ////////////////////////////////////////////////////////
+  //
+  //  TWOWIRE INTERFACE
+  //
+  void beginTransmission(uint8_t address)
+  {
+    _txAddress = address;
+    _txCount   = 0;
+  }
+
+
+  uint8_t endTransmission()
+  {
+    return endTransmission(true);
+  }
+
+
+  uint8_t endTransmission(bool stop)
+  {
+    (void) stop;
+    if ((_txAddress != _address) || !_connected) return 2;  //  NACK on address
+    if (_failNext > 0)
+    {
+      _failNext--;
+      return 2;
+    }
+    _writes++;
+    if (_busTime > 0) delayMicroseconds(_busTime);
+    if (_txCount == 0) return 0;       //  address probe
+    _update();
+    _pointer = _tx[0];
+    _pointerWrites++;
+    if (_txCount >= 3)
+    {
+      _writeRegister(_pointer, (_tx[1] << 8) | _tx[2]);
+    }
+    return 0;
+  }
+
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity)
+  {
+    return _request(address, quantity);
+  }
+
+
+  size_t requestFrom(uint8_t address, size_t quantity)
+  {
+    return _request(address, quantity);
+  }
+
+
+  size_t requestFrom(uint8_t address, size_t quantity, bool stop)
+  {
+    (void) stop;
+    return _request(address, quantity);
+  }
+
+
+  int peek()
+  {
+    if (_rxIndex >= _rxCount) return -1;
+    return _rx[_rxIndex];
+  }
+
+
+private:
+  uint8_t _request(uint8_t address, size_t quantity)
+  {
+    _rxCount = 0;
+    _rxIndex = 0;
+    if ((address != _address) || !_connected) return 0;
+    if (_failNext > 0)
+    {
+      _failNext--;
+      return 0;
+    }
+    _reads++;
+    if (_busTime > 0) delayMicroseconds(_busTime);
+    _update();
+    uint16_t value = _readRegister(_pointer);
+    for (size_t i = 0; i < quantity && i < 2; i++)
+    {
+      _rx[_rxCount++] = (i == 0) ? (value >> 8) : (value & 0xFF);
+    }
+    return _rxCount;
+  }
+
+
+public:
+  size_t write(uint8_t value)
+  {
+    if (_txCount < sizeof(_tx)) _tx[_txCount++] = value;
+    return 1;
+  }
+
+
+  int available()
+  {
+    return _rxCount - _rxIndex;
+  }
+
+
+  int read()
+  {
+    if (_rxIndex >= _rxCount) return -1;
+    return _rx[_rxIndex++];
+  }
+
+
+private:
+  uint8_t  _address;
+  bool     _connected;
+  uint8_t  _failNext;
+  uint16_t _busTime;
+  uint16_t _manufacturer;
+  uint16_t _die;
+
+  //  register file
+  uint16_t _config;
+  int16_t  _shunt;
+  uint16_t _bus;
+  uint16_t _power;
+  int16_t  _current;
+  uint16_t _calibration;
+  uint16_t _mask;
+  uint16_t _limit;
+  uint8_t  _pointer;
+
+  //  conversion state
+  uint32_t _start;         //  emulation start
+  uint32_t _cycleStart;    //  start of current conversion
+  bool     _busy;
+  bool     _alert;
+  bool     _aff;
+  uint32_t _conversions;
+
+  //  signals
+  float    _shuntV;
+  float    _busV;
+  INA226_waveform _shuntWave;
+  INA226_waveform _busWave;
+
+  //  I2C buffers
+  uint8_t  _txAddress;
+  uint8_t  _tx[4];
+  uint8_t  _txCount;
+  uint8_t  _rx[2];
+  uint8_t  _rxCount;
+  uint8_t  _rxIndex;
+  uint32_t _writes = 0;
+  uint32_t _reads = 0;
+  uint32_t _pointerWrites = 0;
+
+
+  void _powerOnReset()
+  {
+    _config      = 0x4127;
+    _shunt       = 0;
+    _bus         = 0;
+    _power       = 0;
+    _current     = 0;
+    _calibration = 0;
+    _mask        = 0;
+    _limit       = 0;
+    _pointer     = 0;
+    _aff         = false;
+    _alert       = false;
+    _conversions = 0;
+    _txCount     = 0;
+    _rxCount     = 0;
+    _rxIndex     = 0;
+    _startConversion();
+  }
+
+
+  void _startConversion()
+  {
+    _cycleStart = micros();
+    _busy = ((_config & 0x0007) != 0) && ((_config & 0x0007) != 4);
+  }
+
+
+  //  run all conversions that completed since the last bus access.
+  void _update()
+  {
+    uint32_t period = conversionPeriod();
+    while (_busy && (micros() - _cycleStart >= period))
+    {
+      _cycleStart += period;
+      _convert(_cycleStart);
+      if ((_config & 0x04) == 0) _busy = false;   //  triggered => single shot
+    }
+  }
+
+
+  void _convert(uint32_t now)
+  {
+    uint32_t t = now - _start;
+    uint8_t mode = _config & 0x0007;
+    if (mode & 0x01)
+    {
+      float v = _shuntWave ? _shuntWave(t) : _shuntV;
+      _shunt = _clamp(lround(v / 2.5e-6), -32768, 32767);
+    }
+    if (mode & 0x02)
+    {
+      float v = _busWave ? _busWave(t) : _busV;
+      _bus = _clamp(lround(v / 1.25e-3), 0, 32767);
+    }
+
+    //  current and power, see datasheet 7.5
+    bool overflow = false;
+    int32_t current = ((int32_t)_shunt * (int32_t)_calibration) / 2048;
+    if ((current > 32767) || (current < -32768)) overflow = true;
+    _current = _clamp(current, -32768, 32767);
+    uint32_t power = ((uint32_t)abs(_current) * _bus) / 20000;
+    if (power > 65535) overflow = true;
+    _power = power > 65535 ? 65535 : power;
+
+    _mask &= ~0x000C;
+    _mask |= 0x0008;                         //  CVRF
+    if (overflow) _mask |= 0x0004;           //  OVF
+
+    //  alert function
+    bool fire = false;
+    int16_t limit = _limit;
+    if      (_mask & 0x8000) fire = _shunt > limit;
+    else if (_mask & 0x4000) fire = _shunt < limit;
+    else if (_mask & 0x2000) fire = _bus   > _limit;
+    else if (_mask & 0x1000) fire = _bus   < _limit;
+    else if (_mask & 0x0800) fire = _power > _limit;
+    if (_mask & 0x0001)  _aff = _aff || fire;   //  latched
+    else                 _aff = fire;
+    if (_aff) _mask |= 0x0010;
+    else      _mask &= ~0x0010;
+
+    //  CNVR enabled => ALERT pin follows CVRF
+    bool cnvr = (_mask & 0x0400) != 0;
+    _alert = _aff || cnvr;
+    _conversions++;
+  }
+
+
+  int32_t _clamp(int32_t value, int32_t low, int32_t high)
+  {
+    if (value < low)  return low;
+    if (value > high) return high;
+    return value;
+  }
+
+
+  uint16_t _reg(uint8_t reg)
+  {
+    switch (reg)
+    {
+      case 0x00: return _config;
+      case 0x01: return _shunt;
+      case 0x02: return _bus;
+      case 0x03: return _power;
+      case 0x04: return _current;
+      case 0x05: return _calibration;
+      case 0x06: return _mask;
+      case 0x07: return _limit;
+      case 0xFE: return _manufacturer;
+      case 0xFF: return _die;
+    }
+    return 0;
+  }
+
+
+  uint16_t _readRegister(uint8_t reg)
+  {
+    uint16_t value = _reg(reg);
+    if (reg == 0x06)
+    {
+      //  reading MASK_ENABLE clears CVRF and a latched alert.
+      _mask &= ~0x0008;
+      if (_mask & 0x0001)
+      {
+        _aff = false;
+        _mask &= ~0x0010;
+      }
+      _alert = _aff;
+    }
+    return value;
+  }
+
+
+  void _writeRegister(uint8_t reg, uint16_t value)
+  {
+    switch (reg)
+    {
+      case 0x00:
+        if (value & 0x8000)
+        {
+          _powerOnReset();
+          return;
+        }
+        _config = value | 0x4000;
+        _mask &= ~0x0008;
+        _startConversion();
+        break;
+      case 0x05:
+        _calibration = value & 0x7FFF;
+        break;
+      case 0x06:
+        _mask = (value & 0xFC03) | (_mask & 0x001C);
+        break;
+      case 0x07:
+        _limit = value;
+        break;
+    }
+  }
+};
+
+
+////////////////////////////////////////////////////////
+//
+//  EMULATOR BUS
+//
+//  multiple emulated devices on one TwoWire, dispatched by address.
+//  addresses without a device NACK.
+class INA226_emulator_bus : public TwoWire
+{
+public:
+  INA226_emulator_bus()
+  {
+    _count    = 0;
+    _txDevice = NULL;
+    _rxDevice = NULL;
+  }
+
+
+  bool attach(INA226_emulator * device)
+  {
+    if (_count >= 16) return false;
+    _devices[_count++] = device;
+    return true;
+  }
+
+
+  void beginTransmission(uint8_t address)
+  {
+    _txDevice = _find(address);
+    if (_txDevice != NULL) _txDevice->beginTransmission(address);
+  }
+
+
+  uint8_t endTransmission()
+  {
+    return endTransmission(true);
+  }
+
+
+  uint8_t endTransmission(bool stop)
+  {
+    if (_txDevice == NULL) return 2;   //  NACK on address
+    return _txDevice->endTransmission(stop);
+  }
+
+
+  uint8_t requestFrom(uint8_t address, uint8_t quantity)
+  {
+    return _request(address, quantity);
+  }
+
+
+  size_t requestFrom(uint8_t address, size_t quantity)
+  {
+    return _request(address, quantity);
+  }
+
+
+  size_t requestFrom(uint8_t address, size_t quantity, bool stop)
+  {
+    (void) stop;
+    return _request(address, quantity);
+  }
+
+
+  size_t write(uint8_t value)
+  {
+    if (_txDevice == NULL) return 0;
+    return _txDevice->write(value);
+  }
+
+
+  int available()
+  {
+    if (_rxDevice == NULL) return 0;
+    return _rxDevice->available();
+  }
+
+
+  int read()
+  {
+    if (_rxDevice == NULL) return -1;
+    return _rxDevice->read();
+  }
+
+
+  int peek()
+  {
+    if (_rxDevice == NULL) return -1;
+    return _rxDevice->peek();
+  }
+
+
+private:
+  INA226_emulator * _find(uint8_t address)
+  {
+    for (uint8_t i = 0; i < _count; i++)
+    {
+      if (_devices[i]->getAddress() == address) return _devices[i];
+    }
+    return NULL;
+  }
+
+
+  uint8_t _request(uint8_t address, size_t quantity)
+  {
+    _rxDevice = _find(address);
+    if (_rxDevice == NULL) return 0;
+    return _rxDevice->requestFrom(address, quantity);
+  }
+
+
+  INA226_emulator * _devices[16];
+  uint8_t           _count;
+  INA226_emulator * _txDevice;
+  INA226_emulator * _rxDevice;
+};
+
+
+//  -- END OF FILE --
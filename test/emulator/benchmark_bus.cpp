@@ -0,0 +1,152 @@
+//
+//    FILE: benchmark_bus.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: I2C cost per sample of the acquisition strategies, with the emulator.
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  usage:  sh test/emulator/run_tests.sh   (builds and runs the benchmarks too)
+//
+//  writes include the pointer writes before a read of another register.
+//  Every transaction takes TRANSACTION_US on the emulated bus, so the time
+//  per sample includes the I2C time, like on hardware at 100 KHz.
+//  Results are deterministic as the host clock only advances with delay().
+
+
+#include <stdio.h>
+
+#include "INA226.h"
+#include "INA226_emulator.h"
+
+
+#define SAMPLES             100
+#define TRANSACTION_US      400
+
+
+typedef uint32_t (*strategy)(INA226 & INA, INA226_emulator & emu);
+
+
+//  four float getters after waiting for the conversion.
+uint32_t getters(INA226 & INA, INA226_emulator & emu)
+{
+  (void) emu;
+  uint32_t count = 0;
+  while (count < SAMPLES)
+  {
+    if (! INA.waitConversionReady()) continue;
+    volatile float x = INA.getBusVoltage();
+    x = INA.getShuntVoltage();
+    x = INA.getCurrent();
+    x = INA.getPower();
+    (void) x;
+    count++;
+  }
+  return count;
+}
+
+
+//  non blocking poll() and one readSample().
+uint32_t pollSample(INA226 & INA, INA226_emulator & emu)
+{
+  (void) emu;
+  INA226Sample sample;
+  uint32_t count = 0;
+  while (count < SAMPLES)
+  {
+    if (INA.poll() && INA.readSample(sample)) count++;
+    else delayMicroseconds(100);
+  }
+  return count;
+}
+
+
+//  coherent read(), checks the ready flag itself.
+uint32_t coherentRead(INA226 & INA, INA226_emulator & emu)
+{
+  (void) emu;
+  INA226Reading reading;
+  uint32_t count = 0;
+  while (count < SAMPLES)
+  {
+    if (INA.read(reading)) count++;
+    else delayMicroseconds(100);
+  }
+  return count;
+}
+
+
+//  conversion ready alert, no I2C traffic until the pin is asserted.
+uint32_t alertDriven(INA226 & INA, INA226_emulator & emu)
+{
+  INA.enableConversionReadyAlert();
+  INA226Sample sample;
+  uint32_t count = 0;
+  while (count < SAMPLES)
+  {
+    if (emu.alertAsserted()) INA.alertInterrupt();
+    if (INA.serviceAlert(sample)) count++;
+    else delayMicroseconds(100);
+  }
+  return count;
+}
+
+
+//  triggered single shot with power down.
+uint32_t singleShot(INA226 & INA, INA226_emulator & emu)
+{
+  (void) emu;
+  INA226Sample sample;
+  uint32_t count = 0;
+  while (count < SAMPLES)
+  {
+    if (INA.measureOnce(sample)) count++;
+  }
+  return count;
+}
+
+
+void run(const char * name, strategy f)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+  INA.begin();
+  INA.setMaxCurrentShunt(1, 0.01);
+  INA.beginConfig();
+  INA.setBusVoltageConversionTime(INA226_1100_us);
+  INA.setShuntVoltageConversionTime(INA226_1100_us);
+  INA.setAverage(INA226_4_SAMPLES);
+  INA.commitConfig();
+  emu.setBusVoltage(12.0);
+  emu.setShuntVoltage(0.005);
+  emu.setTransactionTime(TRANSACTION_US);
+  emu.resetStatistics();
+
+  uint32_t start = micros();
+  uint32_t count = f(INA, emu);
+  uint32_t duration = micros() - start;
+
+  uint32_t transactions = emu.getReadTransactions() + emu.getWriteTransactions();
+  printf("%-14s %8.2f %8.2f %8.2f %10lu\n", name,
+         (float)emu.getReadTransactions() / count,
+         (float)emu.getWriteTransactions() / count,
+         (float)transactions * TRANSACTION_US / count,
+         (unsigned long)(duration / count));
+}
+
+
+int main()
+{
+  printf("\nINA226_LIB_VERSION: %s\n", INA226_LIB_VERSION);
+  printf("%d samples, %d us per transaction\n\n", SAMPLES, TRANSACTION_US);
+  printf("%-14s %8s %8s %8s %10s\n", "strategy", "reads", "writes", "I2C us", "us/sample");
+  run("getters",      getters);
+  run("poll+sample",  pollSample);
+  run("read",         coherentRead);
+  run("alert",        alertDriven);
+  run("measureOnce",  singleShot);
+  printf("\n");
+  return 0;
+}
+
+
+//  -- END OF FILE --
@@ -0,0 +1,68 @@
+#pragma once
+//
+//    FILE: Arduino.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: minimal host side Arduino core for the emulator unit tests.
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  The clock works like the arduino_ci godmode clock, it only advances
+//  with delay() and delayMicroseconds(). Tests and emulator are deterministic.
+//  The clock is atomic so it can be shared by std::threads.
+
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+#define F(x)              (x)
+using std::min;
+using std::max;
+
+#define HIGH              1
+#define LOW               0
+#define INPUT             0
+#define OUTPUT            1
+#define INPUT_PULLUP      2
+
+
+inline std::atomic<unsigned long> & _hostMicros()
+{
+  static std::atomic<unsigned long> now(0);
+  return now;
+}
+
+inline unsigned long micros()     { return _hostMicros().load(); }
+inline unsigned long millis()     { return _hostMicros().load() / 1000; }
+inline void delay(unsigned long ms)
+{
+  _hostMicros() += ms * 1000;
+  std::this_thread::yield();
+}
+inline void delayMicroseconds(unsigned int us)
+{
+  _hostMicros() += us;
+  std::this_thread::yield();
+}
+inline void yield()               { std::this_thread::yield(); }
+
+
+inline void pinMode(uint8_t, uint8_t)      {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int  digitalRead(uint8_t)           { return HIGH; }
+inline void noInterrupts()                 {}
+inline void interrupts()                   {}
+
+
+//  -- END OF FILE --
+
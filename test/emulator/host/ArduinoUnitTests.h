@@ -0,0 +1,97 @@
+#pragma once
+//
+//    FILE: ArduinoUnitTests.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: minimal host side unit test framework for the emulator unit tests.
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Same macros and argument order as arduino_ci, see
+//  https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//  e.g. assertLess(upperBound, actual) checks upperBound < actual.
+
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+
+struct _HostTest
+{
+  const char * name;
+  void (*test)();
+};
+
+inline std::vector<_HostTest> & _hostTests()
+{
+  static std::vector<_HostTest> tests;
+  return tests;
+}
+
+inline int & _hostFailures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+struct _HostTestRegister
+{
+  _HostTestRegister(const char * name, void (*test)())
+  {
+    _hostTests().push_back({ name, test });
+  }
+};
+
+
+#define unittest(name)                                                  \
+  static void _test_##name();                                           \
+  static _HostTestRegister _register_##name(#name, _test_##name);       \
+  static void _test_##name()
+
+#define unittest_setup()         static void _hostSetup()
+#define unittest_teardown()      static void _hostTeardown()
+
+#define unittest_main()                                                 \
+  int main()                                                            \
+  {                                                                     \
+    for (auto & t : _hostTests())                                       \
+    {                                                                   \
+      _hostSetup();                                                     \
+      fprintf(stderr, "-- %s\n", t.name);                               \
+      t.test();                                                         \
+      _hostTeardown();                                                  \
+    }                                                                   \
+    fprintf(stderr, "failures: %d\n", _hostFailures());                 \
+    return _hostFailures() != 0;                                        \
+  }
+
+
+#define _hostCheck(condition, text)                                     \
+  do {                                                                  \
+    if (!(condition))                                                   \
+    {                                                                   \
+      _hostFailures()++;                                                \
+      fprintf(stderr, "FAIL %s:%d %s\n", __FILE__, __LINE__, text);     \
+    }                                                                   \
+  } while (0)
+
+
+#define assertEqual(a, b)              _hostCheck((a) == (b), #a " == " #b)
+#define assertNotEqual(a, b)           _hostCheck((a) != (b), #a " != " #b)
+#define assertLess(a, b)               _hostCheck((a) <  (b), #a " < " #b)
+#define assertMore(a, b)               _hostCheck((a) >  (b), #a " > " #b)
+#define assertLessOrEqual(a, b)        _hostCheck((a) <= (b), #a " <= " #b)
+#define assertMoreOrEqual(a, b)        _hostCheck((a) >= (b), #a " >= " #b)
+#define assertTrue(a)                  _hostCheck((a), #a)
+#define assertFalse(a)                 _hostCheck(!(a), "!" #a)
+#define assertNull(a)                  _hostCheck((a) == NULL, #a " == NULL")
+#define assertEqualFloat(a, b, e)      _hostCheck(fabs((a) - (b)) <= (e), #a " ~ " #b)
+#define assertNotEqualFloat(a, b, e)   _hostCheck(fabs((a) - (b)) >= (e), #a " !~ " #b)
+#define assertInfinity(a)              _hostCheck(isinf(a), "isinf(" #a ")")
+#define assertNotInfinity(a)           _hostCheck(!isinf(a), "!isinf(" #a ")")
+#define assertNAN(a)                   _hostCheck(isnan(a), "isnan(" #a ")")
+#define assertNotNAN(a)                _hostCheck(!isnan(a), "!isnan(" #a ")")
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,16 @@
+//
+//    FILE: Wire.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: minimal host side TwoWire for the emulator unit tests.
+//     URL: https://github.com/RobTillaart/INA226
+
+
+#include "Wire.h"
+
+
+TwoWire Wire;
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,38 @@
+#pragma once
+//
+//    FILE: Wire.h
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: minimal host side TwoWire for the emulator unit tests.
+//     URL: https://github.com/RobTillaart/INA226
+//
+//  Transaction functions are virtual so INA226_emulator can override them.
+//  Wire itself has no devices, every address NACKs.
+
+
+#include "Arduino.h"
+
+
+class TwoWire
+{
+public:
+  virtual ~TwoWire()                        {}
+  virtual void    begin()                   {}
+  virtual void    setClock(uint32_t)        {}
+  virtual void    beginTransmission(uint8_t) {}
+  virtual uint8_t endTransmission()         { return 2; }
+  virtual uint8_t endTransmission(bool)     { return 2; }
+  virtual uint8_t requestFrom(uint8_t, uint8_t) { return 0; }
+  virtual size_t  requestFrom(uint8_t, size_t)  { return 0; }
+  virtual size_t  requestFrom(uint8_t, size_t, bool) { return 0; }
+  virtual size_t  write(uint8_t)            { return 1; }
+  virtual int     available()               { return 0; }
+  virtual int     read()                    { return -1; }
+  virtual int     peek()                    { return -1; }
+};
+
+extern TwoWire Wire;
+
+
+//  -- END OF FILE --
+
@@ -0,0 +1,48 @@
+#!/bin/sh
+#
+#    FILE: run_tests.sh
+#  AUTHOR: Rob Tillaart
+#    DATE: 2026-10-17
+# PURPOSE: build and run the emulator unit tests on the host.
+#     URL: https://github.com/RobTillaart/INA226
+#
+#  usage:  sh test/emulator/run_tests.sh
+#
+#  The tests run twice, without and with INA226_BUS_STATISTICS.
+#  Then the benchmarks run once.
+#  CXX and CXXFLAGS can be overruled, e.g. CXXFLAGS=-fsanitize=thread
+
+
+set -e
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/../.." && pwd)
+CXX=${CXX:-g++}
+BUILD=${BUILD:-$(mktemp -d)}
+
+for DEFINES in "" "-DINA226_BUS_STATISTICS"
+do
+  for TEST in "$HERE"/unit_test_*.cpp
+  do
+    NAME=$(basename "$TEST" .cpp)
+    echo "== $NAME $DEFINES"
+    $CXX -std=gnu++11 -Wall -Wextra $CXXFLAGS $DEFINES \
+      -I"$HERE/host" -I"$ROOT" -I"$HERE" \
+      -o "$BUILD/$NAME" "$TEST" "$ROOT"/INA226*.cpp "$HERE/host/Wire.cpp" -lpthread
+    "$BUILD/$NAME"
+  done
+done
+
+#  benchmarks, no pass / fail, print the I2C cost per sample.
+for BENCH in "$HERE"/benchmark_*.cpp
+do
+  NAME=$(basename "$BENCH" .cpp)
+  echo "== $NAME"
+  $CXX -std=gnu++11 -Wall -Wextra $CXXFLAGS \
+    -I"$HERE/host" -I"$ROOT" -I"$HERE" \
+    -o "$BUILD/$NAME" "$BENCH" "$ROOT"/INA226*.cpp "$HERE/host/Wire.cpp" -lpthread
+  "$BUILD/$NAME"
+done
+
+
+#  -- END OF FILE --
@@ -0,0 +1,1007 @@
+//
+//    FILE: unit_test_emulator.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: unit tests for the INA226 library with the register level emulator
+//          https://github.com/RobTillaart/INA226
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+// supported assertions
+// ----------------------------
+// assertEqual(expected, actual);               // a == b
+// assertNotEqual(unwanted, actual);            // a != b
+// assertComparativeEquivalent(expected, actual);    // abs(a - b) == 0 or (!(a > b) && !(a < b))
+// assertComparativeNotEquivalent(unwanted, actual); // abs(a - b) > 0  or ((a > b) || (a < b))
+// assertLess(upperBound, actual);              // a < b
+// assertMore(lowerBound, actual);              // a > b
+// assertLessOrEqual(upperBound, actual);       // a <= b
+// assertMoreOrEqual(lowerBound, actual);       // a >= b
+// assertTrue(actual);
+// assertFalse(actual);
+// assertNull(actual);
+
+// // special cases for floats
+// assertEqualFloat(expected, actual, epsilon);    // fabs(a - b) <= epsilon
+// assertNotEqualFloat(unwanted, actual, epsilon); // fabs(a - b) >= epsilon
+// assertInfinity(actual);                         // isinf(a)
+// assertNotInfinity(actual);                      // !isinf(a)
+// assertNAN(arg);                                 // isnan(a)
+// assertNotNAN(arg);                              // !isnan(a)
+
+#include <ArduinoUnitTests.h>
+
+
+#include "INA226.h"
+#include "INA226Fixed.h"
+#include "INA226Array.h"
+#include "INA226Capture.h"
+#include "INA226_emulator.h"
+
+
+//  step of 10 mV after 50 ms
+float shuntStep(uint32_t t)
+{
+  return (t < 50000UL) ? 0 : 0.010;
+}
+
+
+//  step of 10 mV after 200 ms
+float shuntStep200(uint32_t t)
+{
+  return (t < 200000UL) ? 0 : 0.010;
+}
+
+
+unittest_setup()
+{
+  fprintf(stderr, "\n INA226_LIB_VERSION: %s\n", (char *) INA226_LIB_VERSION);
+}
+
+unittest_teardown()
+{
+}
+
+
+unittest(test_identity)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+  INA226 INB(0x41, &emu);
+
+  assertTrue(INA.begin());
+  assertFalse(INB.begin());
+  assertEqual(0x5449, INA.getManufacturerID());
+  assertEqual(0x2260, INA.getDieID());
+}
+
+
+unittest(test_pointer_cache)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  emu.resetStatistics();
+  for (int i = 0; i < 10; i++)
+  {
+    INA.getCurrentRaw();
+  }
+  assertEqual(10, emu.getReadTransactions());
+  assertEqual(1, emu.getPointerWrites());
+  INA.getBusVoltageRaw();
+  assertEqual(2, emu.getPointerWrites());
+  assertEqual(0x02, emu.getPointer());
+}
+
+
+unittest(test_config_cache)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  emu.resetStatistics();
+  INA.beginConfig();
+  INA.setAverage(INA226_64_SAMPLES);
+  INA.setBusVoltageConversionTime(INA226_332_us);
+  INA.setShuntVoltageConversionTime(INA226_588_us);
+  INA.setMode(5);
+  assertEqual(0, emu.getWriteTransactions());
+  assertTrue(INA.commitConfig());
+  assertEqual(1, emu.getWriteTransactions());
+  assertEqual(0x4000 | (3 << 9) | (2 << 6) | (3 << 3) | 5, emu.peekRegister(0x00));
+
+  //  getters do not use the bus
+  assertEqual(INA226_64_SAMPLES, INA.getAverage());
+  assertEqual(0, emu.getReadTransactions());
+  assertEqual(64 * 588, INA.getConversionPeriod_us());
+  assertEqual(64 * 588, emu.conversionPeriod());
+
+  assertTrue(INA.reset());
+  assertEqual(0x4127, emu.peekRegister(0x00));
+  assertEqual(7, INA.getMode());
+}
+
+
+unittest(test_measurements)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  assertEqual(INA226_ERR_NONE, INA.setMaxCurrentShunt(1, 0.05));
+  assertEqual(2048, emu.peekRegister(0x05));
+  emu.setShuntVoltage(0.010);
+  emu.setBusVoltage(12.0);
+
+  assertTrue(INA.waitConversionReady());
+  assertEqualFloat(0.010, INA.getShuntVoltage(), 1e-5);
+  assertEqualFloat(12.0, INA.getBusVoltage(), 0.002);
+  assertEqualFloat(0.2, INA.getCurrent(), 0.0001);
+  assertEqualFloat(2.4, INA.getPower(), 0.002);
+
+  assertEqual(10000, INA.getShuntVoltageInt_uV());
+  assertEqual(12000, INA.getBusVoltageInt_mV());
+  assertEqual(200000, INA.getCurrentInt_uA());
+  assertEqual(2400000, INA.getPowerInt_uW());
+}
+
+
+unittest(test_triggered_mode)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  INA.beginConfig();
+  INA.setBusVoltageConversionTime(INA226_140_us);
+  INA.setShuntVoltageConversionTime(INA226_140_us);
+  INA.setModeShuntBusTrigger();
+  INA.commitConfig();
+  assertTrue(INA.isConverting());
+
+  bool ready = false;
+  for (int i = 0; (i < 100) && !ready; i++)
+  {
+    delay(1);
+    ready = INA.poll();
+  }
+  assertTrue(ready);
+  assertFalse(INA.isConverting());
+  assertEqual(1, emu.getConversionCount());
+
+  //  no conversion running => no I2C
+  emu.resetStatistics();
+  assertFalse(INA.poll());
+  assertEqual(0, emu.getReadTransactions());
+
+  //  single shot
+  delay(10);
+  assertEqual(1, emu.getConversionCount());
+  assertTrue(INA.startConversion());
+  assertTrue(INA.waitConversionReady());
+  assertEqual(2, emu.getConversionCount());
+}
+
+
+unittest(test_wait_predicted)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  //  16 x (1100 + 1100) = 35200 us
+  INA.beginConfig();
+  INA.setAverage(INA226_16_SAMPLES);
+  INA.setModeShuntBusTrigger();
+  INA.commitConfig();
+  emu.resetStatistics();
+
+  uint32_t start = micros();
+  assertTrue(INA.waitConversionReady());
+  uint32_t duration = micros() - start;
+  assertFalse(INA.isConverting());
+  assertEqual(1, emu.getConversionCount());
+  //  sleeps most of the period, 1 ms polling would need ~35 reads.
+  assertLessOrEqual(emu.getReadTransactions(), 10);
+  assertMoreOrEqual(duration, 30000);
+
+  //  timeout shorter than the conversion
+  assertTrue(INA.startConversion());
+  assertFalse(INA.waitConversionReady(5));
+}
+
+
+unittest(test_measure_once)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  assertEqual(0, INA.setMaxCurrentShunt(1, 0.01));
+  assertTrue(INA.setAverage(INA226_4_SAMPLES));
+  emu.setShuntVoltage(0.005);
+  emu.setBusVoltage(12.0);
+  uint32_t period = INA.getConversionPeriod_us();
+  emu.resetStatistics();
+
+  INA226Sample sample;
+  assertTrue(INA.measureOnce(sample));
+  assertEqual(1, emu.getConversionCount());
+  //  trigger, pointer MASK, SHUNT, BUS, CURRENT, power down.
+  assertEqual(6, emu.getWriteTransactions());
+  assertEqual(0, INA.getMode());
+  assertEqual(INA226_4_SAMPLES, INA.getAverage());
+  assertEqual(0, emu.peekRegister(0x00) & 0x0007);
+  assertFalse(INA.isConverting());
+  assertEqual(2000, sample.shunt);
+  assertEqual(9600, sample.bus);
+  assertEqual(emu.peekRegister(0x03), sample.power);
+  assertMoreOrEqual(INA.getActiveTime_us(), period);
+}
+
+
+unittest(test_overflow_flag)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  //  current_LSB 10 uA => CALIBRATION = 10240
+  assertEqual(INA226_ERR_NONE, INA.configure(0.05, 0.01));
+  emu.setShuntVoltage(0.080);
+  assertTrue(INA.waitConversionReady());
+  assertEqual(INA226_MATH_OVERFLOW_FLAG, INA.getLastAlertFlag() & INA226_MATH_OVERFLOW_FLAG);
+
+  emu.setShuntVoltage(0.001);
+  delay(10);
+  assertEqual(0, INA.getAlertFlag() & INA226_MATH_OVERFLOW_FLAG);
+}
+
+
+unittest(test_alert_function)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  emu.setBusVoltage(5.0);
+  assertTrue(INA.setAlertRegister(INA226_BUS_OVER_VOLTAGE));
+  assertTrue(INA.setAlertLimit(8000));    //  10 V
+  delay(10);
+  assertFalse(emu.alertAsserted());
+  assertEqual(0, INA.getAlertFlag() & INA226_ALERT_FUNCTION_FLAG);
+
+  emu.setBusVoltage(12.0);
+  delay(10);
+  assertTrue(emu.alertAsserted());
+  assertEqual(LOW, emu.alertPinLevel());
+  //  the library has no APOL setter, write MASK_ENABLE directly.
+  emu.beginTransmission(0x40);
+  emu.write(0x06);
+  emu.write((INA226_BUS_OVER_VOLTAGE >> 8) & 0xFF);
+  emu.write(INA226_ALERT_POLARITY_FLAG);
+  assertEqual(0, emu.endTransmission());
+  assertTrue(emu.alertAsserted());
+  assertEqual(HIGH, emu.alertPinLevel());
+  assertEqual(INA226_ALERT_FUNCTION_FLAG, INA.getAlertFlag() & INA226_ALERT_FUNCTION_FLAG);
+
+  //  conversion ready alert
+  emu.setBusVoltage(5.0);
+  assertTrue(INA.setAlertRegister(INA226_CONVERSION_READY));
+  delay(10);
+  assertTrue(emu.alertAsserted());
+  INA.getAlertFlag();
+  assertFalse(emu.alertAsserted());
+}
+
+
+unittest(test_service_alert)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+  INA226Sample sample;
+
+  assertTrue(INA.begin());
+  assertEqual(0, INA.setMaxCurrentShunt(1, 0.01));
+  assertTrue(INA.enableConversionReadyAlert());
+  assertFalse(INA.serviceAlert(sample));    //  no interrupt yet
+  emu.setBusVoltage(12.0);
+  delay(10);
+  assertTrue(emu.alertAsserted());
+
+  //  I2C error on the MASK_ENABLE read, the alert stays pending.
+  INA.alertInterrupt();
+  emu.failNext(1);
+  assertFalse(INA.serviceAlert(sample));
+  assertTrue(INA.isAlertPending());
+  assertTrue(emu.alertAsserted());
+
+  //  no new edge needed, next call services the alert.
+  assertTrue(INA.serviceAlert(sample));
+  assertFalse(INA.isAlertPending());
+  assertFalse(emu.alertAsserted());
+  assertEqual(9600, sample.bus);
+}
+
+
+unittest(test_alert_limits)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  //  not calibrated
+  assertFalse(INA.setShuntOverCurrentLimit(0.5));
+  assertEqual(0, INA.setMaxCurrentShunt(1, 0.01));
+
+  //  0.5 A x 0.01 Ohm = 5 mV = 2000 x 2.5 uV
+  assertTrue(INA.setShuntOverCurrentLimit(0.5));
+  assertEqual(INA226_SHUNT_OVER_VOLTAGE, INA.getAlertRegister());
+  assertEqualFloat(0.5, INA.getAlertLimitValue(), 0.0001);
+  assertEqual(2000, emu.peekRegister(0x07));
+  emu.setShuntVoltage(0.004);
+  delay(10);
+  assertEqual(0, INA.getAlertEvent());
+  emu.setShuntVoltage(0.006);
+  delay(10);
+  assertEqual(INA226_SHUNT_OVER_VOLTAGE, INA.getAlertEvent());
+
+  //  negative limit
+  assertTrue(INA.setShuntUnderCurrentLimit(-0.25));
+  assertEqual(-1000, (int16_t)emu.peekRegister(0x07));
+  assertEqual(INA226_SHUNT_UNDER_VOLTAGE, INA.getAlertRegister());
+  assertFalse(INA.setShuntOverCurrentLimit(10));    //  out of range
+
+  //  bus 10.0 V = 8000 x 1.25 mV, CONVERSION_READY is kept.
+  assertTrue(INA.enableConversionReadyAlert());
+  assertTrue(INA.setBusUnderVoltageLimit(10.0));
+  assertEqual(INA226_BUS_UNDER_VOLTAGE | INA226_CONVERSION_READY, INA.getAlertRegister());
+  assertEqual(8000, emu.peekRegister(0x07));
+  emu.setBusVoltage(12.0);
+  delay(10);
+  assertEqual(INA226_CONVERSION_READY, INA.getAlertEvent());
+  emu.setBusVoltage(9.0);
+  delay(10);
+  assertEqual(INA226_BUS_UNDER_VOLTAGE, INA.getAlertEvent());
+  assertTrue(INA.setBusOverVoltageLimit(40.95));
+  assertEqual(32760, emu.peekRegister(0x07));
+  assertFalse(INA.setBusOverVoltageLimit(41));
+
+  //  power limit follows the calibration.
+  assertTrue(INA.setPowerOverLimit(5.0));
+  uint16_t limit = round(5.0 / (25 * INA.getCurrentLSB()));
+  assertEqual(limit, emu.peekRegister(0x07));
+  assertEqual(0, INA.setMaxCurrentShunt(4, 0.01));
+  limit = round(5.0 / (25 * INA.getCurrentLSB()));
+  assertEqual(limit, emu.peekRegister(0x07));
+  assertEqual(INA226_POWER_OVER_LIMIT | INA226_CONVERSION_READY, INA.getAlertRegister());
+
+  //  a raw limit disables the re-conversion.
+  assertTrue(INA.setAlertLimit(100));
+  assertEqualFloat(0, INA.getAlertLimitValue(), 0.0001);
+  assertEqual(0, INA.setMaxCurrentShunt(1, 0.01));
+  assertEqual(100, emu.peekRegister(0x07));
+
+  //  typed limit that does not fit the new calibration disables the alert.
+  assertEqual(0, INA.setMaxCurrentShunt(4, 0.01));
+  assertTrue(INA.setPowerOverLimit(5.0));
+  assertEqual(INA226_ERR_ALERT_DISABLED, INA.setMaxCurrentShunt(0.05, 0.1));
+  assertEqualFloat(0, INA.getAlertLimitValue(), 0.0001);
+  assertEqual(INA226_CONVERSION_READY, INA.getAlertRegister());
+  assertEqual(INA226_CONVERSION_READY, emu.peekRegister(0x06) & 0xFC00);
+  assertEqual(INA226_ERR_NONE, INA.configure(0.01, 0.1));
+
+  //  a raw alert function disables the re-conversion.
+  assertTrue(INA.setPowerOverLimit(1.0));
+  limit = emu.peekRegister(0x07);
+  assertTrue(INA.enableConversionReadyAlert());
+  assertEqualFloat(1.0, INA.getAlertLimitValue(), 0.0001);
+  assertTrue(INA.setAlertRegister(INA226_BUS_OVER_VOLTAGE));
+  assertEqualFloat(0, INA.getAlertLimitValue(), 0.0001);
+  assertEqual(0, INA.setMaxCurrentShunt(4, 0.01));
+  assertEqual(limit, emu.peekRegister(0x07));
+}
+
+
+unittest(test_waveform)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  emu.setShuntWaveform(shuntStep);
+  assertTrue(INA.waitConversionReady());
+  assertEqual(0, INA.getShuntVoltageRaw());
+  delay(100);
+  assertEqual(4000, INA.getShuntVoltageRaw());
+}
+
+
+unittest(test_capture)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+  INA226Capture<64> capture(&INA);
+
+  assertTrue(INA.begin());
+  assertFalse(capture.setTriggerCurrent(1.0));    //  not calibrated
+  assertEqual(0, INA.setMaxCurrentShunt(4, 0.01));
+  assertTrue(capture.begin());
+  assertEqual(5, INA.getMode());
+  assertEqual(140, capture.getInterval());
+
+  //  5 mV = 0.5 A x 0.01 Ohm
+  assertTrue(capture.setTriggerCurrent(0.5));
+  assertEqual(2000, capture.getTriggerLevel());
+  capture.setPostTrigger(16);
+  assertEqual(INA226_CAPTURE_IDLE, capture.getState());
+  assertFalse(capture.update());
+
+  //  pre-trigger window is filled before the step.
+  emu.setShuntWaveform(shuntStep200);
+  capture.arm();
+  emu.resetStatistics();
+  for (int i = 0; (i < 500) && !capture.isDone(); i++)
+  {
+    delay(1);
+    capture.update();
+  }
+  assertTrue(capture.isDone());
+  assertFalse(capture.update());
+  assertEqual(64, capture.count());
+  assertEqual(48, capture.getTriggerIndex());
+  assertEqual(0, capture.get(47));
+  assertEqual(4000, capture.get(48));
+  assertEqual(4000, capture.get(63));
+  //  only SHUNT reads, pointer set once.
+  assertEqual(1, emu.getWriteTransactions());
+  assertMore(capture.getSamplePeriod_us(), 0);
+
+  //  slope trigger, forced trigger
+  capture.setTrigger(INA226_TRIGGER_SLOPE, -1000);
+  assertEqual(INA226_TRIGGER_SLOPE, capture.getTriggerType());
+  capture.arm();
+  delay(1);
+  assertTrue(capture.update());
+  capture.trigger();
+  assertEqual(INA226_CAPTURE_TRIGGERED, capture.getState());
+  for (int i = 0; (i < 100) && !capture.isDone(); i++)
+  {
+    delay(1);
+    capture.update();
+  }
+  assertTrue(capture.isDone());
+  assertEqual(17, capture.count());
+  assertEqual(1, capture.getTriggerIndex());
+
+  //  conversion sync, one sample per conversion.
+  capture.setConversionSync(true);
+  assertTrue(capture.getConversionSync());
+  capture.arm();
+  emu.peekRegister(0x00);
+  uint32_t conversions = emu.getConversionCount();
+  for (int i = 0; i < 200; i++)
+  {
+    delayMicroseconds(10);
+    capture.update();
+  }
+  emu.peekRegister(0x00);
+  conversions = emu.getConversionCount() - conversions;
+  assertEqual(14, conversions);
+  //  a conversion finished before arm() can add one sample.
+  assertMoreOrEqual((uint32_t)capture.count(), conversions);
+  assertLessOrEqual((uint32_t)capture.count(), conversions + 1);
+
+  //  zero offset 100 mA => 0.6 A x 0.01 Ohm, not for a slope.
+  assertEqual(0, INA.configure(0.01, 0.1, 100));
+  assertTrue(capture.setTriggerCurrent(0.5));
+  assertEqual(2400, capture.getTriggerLevel());
+  assertTrue(capture.setTriggerCurrent(0.1, INA226_TRIGGER_SLOPE));
+  assertEqual(400, capture.getTriggerLevel());
+}
+
+
+unittest(test_bus_error)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  emu.setConnected(false);
+  assertEqual(0, INA.getBusVoltageRaw());
+  assertEqual(-1, INA.getLastError());
+  assertFalse(INA.isConnected());
+
+  emu.setConnected(true);
+  INA.getBusVoltageRaw();
+  assertEqual(0, INA.getLastError());
+}
+
+
+unittest(test_retries_valid)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  emu.setBusVoltage(12.0);
+  delay(5);
+  assertEqual(9600, INA.getBusVoltageRaw());
+  assertTrue(INA.isValid());
+
+  //  failed read returns 0, isValid() tells it apart.
+  emu.failNext(1);
+  assertEqual(0, INA.getBusVoltageRaw());
+  assertFalse(INA.isValid());
+  assertEqual(-2, INA.getLastError());   //  pointer cached, read fails
+  assertFalse(INA.isValid());
+
+  //  retries hide transient errors.
+  assertEqual(0, INA.getRetries());
+  INA.setRetries(2);
+  assertEqual(2, INA.getRetries());
+  emu.failNext(2);
+  assertEqual(9600, INA.getBusVoltageRaw());
+  assertTrue(INA.isValid());
+  assertEqual(0, INA.getLastError());
+  //  getLastError() reflects the last write attempt, like reads.
+  emu.failNext(1);
+  assertTrue(INA.setAverage(INA226_16_SAMPLES));
+  assertEqual(0, INA.getLastError());
+  emu.failNext(3);
+  assertFalse(INA.setAverage(INA226_4_SAMPLES));
+  assertFalse(INA.isValid());
+  assertEqual(-1, INA.getLastError());
+}
+
+
+unittest(test_recover)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  assertEqual(0, INA.setMaxCurrentShunt(1, 0.01));
+  assertTrue(INA.setAverage(INA226_16_SAMPLES));
+  assertTrue(INA.setAlertLimit(1000));
+  assertTrue(INA.setAlertRegister(INA226_BUS_OVER_VOLTAGE));
+  uint16_t config = emu.peekRegister(0x00);
+  uint16_t calibration = emu.peekRegister(0x05);
+
+  //  device lost power
+  emu.setConnected(false);
+  assertFalse(INA.recover());
+  emu.setConnected(true);
+  emu.powerOnReset();
+  assertEqual(0x4127, emu.peekRegister(0x00));
+  assertEqual(0, emu.peekRegister(0x05));
+
+  assertTrue(INA.recover());
+  assertEqual(config, emu.peekRegister(0x00));
+  assertEqual(calibration, emu.peekRegister(0x05));
+  assertEqual(INA226_BUS_OVER_VOLTAGE, emu.peekRegister(0x06) & 0xFC00);
+  assertEqual(1000, emu.peekRegister(0x07));
+}
+
+
+unittest(test_array_quarantine)
+{
+  INA226_emulator emu0(0x40);
+  INA226_emulator emu1(0x41);
+  INA226 INA0(0x40, &emu0);
+  INA226 INA1(0x41, &emu1);
+  INA226Array arr;
+
+  assertTrue(INA0.begin());
+  assertTrue(INA1.begin());
+  INA0.setSampleRate(1000);
+  INA1.setSampleRate(1000);
+  arr.add(&INA0);
+  arr.add(&INA1);
+  assertTrue(arr.begin());
+
+  //  device 1 drops off the bus
+  emu1.setConnected(false);
+  for (int i = 0; i < 100; i++)
+  {
+    delay(1);
+    arr.update();
+  }
+  assertTrue(arr.isQuarantined(1));
+  assertFalse(arr.isQuarantined(0));
+  assertEqual(0, arr.getFailures(0));
+  assertMoreOrEqual(arr.getFailures(1), INA226_ARRAY_QUARANTINE);
+  //  healthy device keeps its rate
+  assertMoreOrEqual(arr.getSampleCount(), 50);
+  //  quarantined device is retried about once per second.
+  uint32_t faults = arr.getFaultCount();
+
+  //  device returns after a power loss.
+  emu1.setConnected(true);
+  emu1.powerOnReset();
+  for (int i = 0; i < 1100; i++)
+  {
+    delay(1);
+    arr.update();
+  }
+  assertLessOrEqual(arr.getFaultCount(), faults + 1);
+  assertEqual(1, arr.getRecoveryCount());
+  assertEqual(0, arr.getFailures(1));
+  assertEqual(INA1.getAverage() << 9, emu1.peekRegister(0x00) & 0x0E00);
+}
+
+
+unittest(test_discover)
+{
+  INA226_emulator emu40(0x40);
+  INA226_emulator emu43(0x43);
+  INA226_emulator emu45(0x45);
+  INA226_emulator emu4F(0x4F);
+  INA226_emulator emu41(0x41);
+  emu45.setIdentity(0x0000, 0x0000);    //  other device type
+  INA226_emulator_bus bus0;
+  INA226_emulator_bus bus1;
+  bus0.attach(&emu40);
+  bus0.attach(&emu43);
+  bus0.attach(&emu45);
+  bus0.attach(&emu4F);
+  bus1.attach(&emu41);
+
+  INA226 pool[16];
+  INA226Array arr;
+  uint8_t n = arr.discover(pool, 16, &bus0);
+  assertEqual(3, n);
+  assertEqual(1, arr.discover(pool + n, 16 - n, &bus1));
+  assertEqual(4, arr.count());
+  assertEqual(0x40, arr.get(0)->getAddress());
+  assertEqual(0x43, arr.get(1)->getAddress());
+  assertEqual(0x4F, arr.get(2)->getAddress());
+  assertEqual(0x41, arr.get(3)->getAddress());
+  assertTrue(pool[0].isINA226());
+
+  //  pool too small
+  INA226 small[1];
+  INA226Array arr2;
+  assertEqual(1, arr2.discover(small, 1, &bus0));
+
+  //  shared profile, calibration math once.
+  INA226 * first = arr.get(0);
+  assertEqual(0, first->setMaxCurrentShunt(1, 0.01));
+  first->beginConfig();
+  first->setAverage(INA226_16_SAMPLES);
+  first->setModeShuntBusTrigger();
+  first->commitConfig();
+  assertTrue(first->setBusUnderVoltageLimit(10.0));
+  emu41.resetStatistics();
+  assertTrue(arr.setProfile(*first));
+  assertEqual(4, emu41.getWriteTransactions());
+  assertEqual(0, emu41.getReadTransactions());
+  for (uint8_t i = 1; i < arr.count(); i++)
+  {
+    INA226 * ina = arr.get(i);
+    assertEqual(first->getCalibration(), ina->getCalibration());
+    assertEqual(INA226_16_SAMPLES, ina->getAverage());
+    assertEqualFloat(first->getCurrentLSB(), ina->getCurrentLSB(), 1e-9);
+  }
+  assertEqual(emu40.peekRegister(0x00), emu4F.peekRegister(0x00));
+  assertEqual(emu40.peekRegister(0x05), emu41.peekRegister(0x05));
+  assertEqual(8000, emu43.peekRegister(0x07));
+  assertEqual(INA226_BUS_UNDER_VOLTAGE, emu43.peekRegister(0x06) & 0xFC00);
+}
+
+
+unittest(test_discover_keeps_config)
+{
+  INA226_emulator emu40(0x40);
+  INA226_emulator_bus bus;
+  bus.attach(&emu40);
+
+  //  device configured before, e.g. by an earlier run of the sketch.
+  INA226 setup(0x40, &bus);
+  assertTrue(setup.begin());
+  assertEqual(0, setup.setMaxCurrentShunt(1, 0.01));
+  setup.beginConfig();
+  setup.setAverage(INA226_16_SAMPLES);
+  setup.setModeShuntBusTrigger();
+  setup.commitConfig();
+  uint16_t config = emu40.peekRegister(0x00);
+
+  //  no setProfile(), trigger() uses the cached registers.
+  INA226 pool[1];
+  INA226Array arr;
+  assertEqual(1, arr.discover(pool, 1, &bus));
+  assertEqual(setup.getCalibration(), pool[0].getCalibration());
+  assertEqual(INA226_16_SAMPLES, pool[0].getAverage());
+  assertTrue(arr.trigger());
+  assertEqual(config, emu40.peekRegister(0x00));
+  assertEqual(setup.getCalibration(), emu40.peekRegister(0x05));
+}
+
+
+unittest(test_array_frame)
+{
+  INA226_emulator emu40(0x40);
+  INA226_emulator emu41(0x41);
+  INA226_emulator emu42(0x42);
+  INA226_emulator_bus bus;
+  bus.attach(&emu40);
+  bus.attach(&emu41);
+  bus.attach(&emu42);
+  emu40.setBusVoltage(5.0);
+  emu41.setBusVoltage(12.0);
+  emu42.setBusVoltage(3.3);
+
+  INA226 pool[3];
+  INA226Array arr;
+  assertEqual(3, arr.discover(pool, 3, &bus));
+  pool[0].beginConfig();
+  pool[0].setAverage(INA226_4_SAMPLES);
+  pool[0].setModeShuntBusTrigger();
+  pool[0].commitConfig();
+  assertTrue(arr.setProfile(pool[0]));
+
+  INA226Sample frame[3];
+  delay(5);
+  uint32_t conversions = emu41.getConversionCount();
+  for (int cycle = 1; cycle <= 3; cycle++)
+  {
+    assertTrue(arr.acquireFrame(frame));
+    assertEqual(conversions + cycle, emu41.getConversionCount());
+  }
+  assertEqual(4000, frame[0].bus);
+  assertEqual(9600, frame[1].bus);
+  assertEqual(2640, frame[2].bus);
+  //  frame timestamps are the trigger times.
+  assertEqual(arr.getTriggerTime(0), frame[0].timestamp);
+  assertEqual(arr.getTriggerTime(2), frame[2].timestamp);
+  assertEqual(frame[2].timestamp - frame[0].timestamp, arr.getTriggerSkew_us());
+  assertLess(arr.getTriggerSkew_us(), 1000);
+  assertEqual(0, arr.getTriggerTime(3));
+
+  //  device lost
+  emu42.setConnected(false);
+  assertFalse(arr.acquireFrame(frame, 20));
+}
+
+
+unittest(test_read_coherent)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  assertEqual(0, INA.setMaxCurrentShunt(1, 0.01));
+  emu.setShuntVoltage(0.005);
+  emu.setBusVoltage(12.0);
+
+  //  continuous, slow conversions => one snapshot.
+  assertTrue(INA.waitConversionReady());
+  INA226Reading reading;
+  assertFalse(INA.read(reading));     //  flag already consumed
+  delay(20);
+  emu.resetStatistics();
+  assertTrue(INA.read(reading));
+  //  MASK, SHUNT, BUS, CURRENT, POWER, MASK
+  assertEqual(6, emu.getReadTransactions());
+  assertEqual(2000, reading.shuntRaw);
+  assertEqual(9600, reading.busRaw);
+  assertEqual(emu.peekRegister(0x04), reading.currentRaw);
+  assertEqual(emu.peekRegister(0x03), reading.powerRaw);
+  assertEqualFloat(0.005, reading.shuntVoltage, 1e-6);
+  assertEqualFloat(12.0, reading.busVoltage, 1e-3);
+  assertEqualFloat(0.5, reading.current, 1e-3);
+  assertEqualFloat(6.0, reading.power, 0.01);
+  assertFalse(reading.overflow);
+
+  //  conversions faster than the reads => never coherent.
+  assertTrue(INA.setBusVoltageConversionTime(INA226_140_us));
+  assertTrue(INA.setShuntVoltageConversionTime(INA226_140_us));
+  assertTrue(INA.setAverage(INA226_1_SAMPLE));
+  emu.setTransactionTime(200);
+  delay(2);
+  assertFalse(INA.read(reading));
+
+  //  triggered mode, registers stay stable after the conversion.
+  assertTrue(INA.setModeShuntBusTrigger());
+  assertTrue(INA.waitConversionReady());
+  assertTrue(INA.startConversion());
+  delay(2);
+  emu.resetStatistics();
+  assertTrue(INA.read(reading));
+  assertEqual(5, emu.getReadTransactions());
+  assertEqual(9600, reading.busRaw);
+  assertFalse(INA.isConverting());
+}
+
+
+unittest(test_auto_range)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  assertFalse(INA.setAutoRange(true));      //  not calibrated
+  //  current_LSB 50 uA => CALIBRATION = 1024
+  assertEqual(0, INA.setMaxCurrentShunt(0.8, 0.1));
+  assertEqual(1024, INA.getCalibration());
+  assertTrue(INA.setAutoRange(true));
+  assertEqual(0, INA.getRange());
+  assertEqualFloat(1.6384, INA.getMaxCurrent(), 1e-4);
+
+  //  standby 1 mA => finest range, CALIBRATION = 16384
+  emu.setShuntVoltage(0.0001);
+  INA226Reading reading;
+  delay(10);
+  assertTrue(INA.read(reading));
+  assertEqual(20, reading.currentRaw);
+  assertEqualFloat(50e-6, reading.currentLSB, 1e-9);
+  assertEqual(4, INA.getRange());
+  assertEqual(1, INA.getRangeSwitches());
+  assertEqual(16384, emu.peekRegister(0x05));
+  assertEqualFloat(3.125e-6, INA.getCurrentLSB(), 1e-10);
+  assertEqualFloat(0.1024, INA.getMaxCurrent(), 1e-5);
+  //  only read() is valid, the registers may hold the previous range.
+  INA226Sample sample;
+  assertFalse(INA.readSample(sample));
+  assertFalse(INA.measureOnce(sample));
+  assertEqual(0, INA.getCurrentRaw());
+  assertEqual(0, INA.getCurrentInt_uA());
+  assertEqualFloat(0, INA.getCurrent(), 1e-9);
+  //  conversion restarted, ready flag cleared.
+  assertFalse(INA.read(reading));
+  delay(10);
+  assertTrue(INA.read(reading));
+  assertEqual(320, reading.currentRaw);
+  assertEqualFloat(0.001, reading.current, 1e-6);
+  assertEqual(1000, INA.convertCurrent_uA(reading.currentRaw));
+  assertEqual(1, INA.getRangeSwitches());
+
+  //  load step 0.8 A => overflow, one switch to CALIBRATION = 2048
+  emu.setShuntVoltage(0.080);
+  delay(10);
+  assertTrue(INA.read(reading));
+  assertTrue(reading.overflow);
+  assertEqual(1, INA.getRange());
+  assertEqual(2, INA.getRangeSwitches());
+  assertEqual(2048, emu.peekRegister(0x05));
+  delay(10);
+  assertTrue(INA.read(reading));
+  assertFalse(reading.overflow);
+  assertEqual(32000, reading.currentRaw);
+  assertEqualFloat(0.8, reading.current, 1e-4);
+  //  hysteresis, 0.3 A stays in range.
+  emu.setShuntVoltage(0.030);
+  delay(10);
+  assertTrue(INA.read(reading));
+  assertFalse(INA.autoRange(reading.shuntRaw));
+  assertEqual(1, INA.getRange());
+
+  //  typed power limit 10 W does not fit the finest range.
+  assertTrue(INA.setPowerOverLimit(10.0));
+  emu.setShuntVoltage(0.0001);
+  delay(10);
+  assertTrue(INA.read(reading));
+  assertEqual(3, INA.getRange());
+  assertEqual(INA.getAlertLimit(), emu.peekRegister(0x07));
+  assertEqualFloat(10.0, INA.getAlertLimitValue(), 0.01);
+
+  //  disable => range 0
+  assertTrue(INA.setAutoRange(false));
+  assertEqual(1024, emu.peekRegister(0x05));
+  assertEqualFloat(50e-6, INA.getCurrentLSB(), 1e-9);
+  assertEqualFloat(1.6384, INA.getMaxCurrent(), 1e-4);
+  assertFalse(INA.autoRange(0));
+}
+
+
+#ifdef INA226_BUS_STATISTICS
+unittest(test_bus_statistics)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+
+  assertTrue(INA.begin());
+  INA.resetBusStatistics();
+  const INA226BusStatistics & stats = INA.getBusStatistics();
+
+  //  pointer write once, then cached.
+  INA.getBusVoltageRaw();
+  INA.getBusVoltageRaw();
+  assertEqual(2, stats.reads[2]);
+  assertEqual(1, stats.pointerWrites);
+  assertEqual(1 + 2 * 2, stats.bytes);
+  assertEqual(2, stats.latency[0]);
+  //  register write
+  assertTrue(INA.setAverage(INA226_4_SAMPLES));
+  assertEqual(1, stats.writes[0]);
+  assertEqual(5 + 3, stats.bytes);
+  //  identification registers 0xFE 0xFF => index 8, 9
+  INA.getManufacturerID();
+  INA.getDieID();
+  assertEqual(1, stats.reads[8]);
+  assertEqual(1, stats.reads[9]);
+  assertEqual(8 + 2 * 3, stats.bytes);
+
+  //  histogram, pointer write + read = 200 us => bucket 2 (128..255 us)
+  emu.setTransactionTime(100);
+  INA.getShuntVoltageRaw();
+  assertEqual(1, stats.latency[2]);
+  emu.setTransactionTime(0);
+  assertEqual(14 + 3, stats.bytes);
+
+  //  read fails, pointer is cached
+  emu.failNext(1);
+  INA.getShuntVoltageRaw();
+  assertEqual(1, stats.errors[0]);
+  assertEqual(17, stats.bytes);
+
+  //  device lost, address NACK => status 2, no bytes counted
+  emu.setConnected(false);
+  INA.getCurrentRaw();
+  assertEqual(1, stats.reads[4]);
+  assertEqual(5, stats.pointerWrites);
+  assertEqual(1, stats.errors[2]);
+  assertFalse(INA.setAverage(INA226_16_SAMPLES));
+  assertEqual(2, stats.writes[0]);
+  assertEqual(2, stats.errors[2]);
+  assertEqual(17, stats.bytes);
+  assertEqual(0, stats.errors[1]);
+
+  uint32_t total = 0;
+  for (int i = 0; i < INA226_BUS_HISTOGRAM; i++) total += stats.latency[i];
+  assertEqual(9, total);
+
+  INA.resetBusStatistics();
+  assertEqual(0, stats.bytes);
+  assertEqual(0, stats.reads[2]);
+}
+#endif
+
+
+unittest(test_fixed_calibration)
+{
+  INA226_emulator emu(0x40);
+  INA226Fixed<2000, 20000> INA(0x40, &emu);   //  2 mOhm, 20 A
+  INA226 REF(0x40, &emu);
+
+  assertEqual(610352, INA.getCurrentLSB_nA());
+  assertEqual(4194, INA.CALIBRATION);
+  assertTrue(INA.begin());
+  assertEqual(4194, emu.peekRegister(0x05));
+
+  //  same as runtime calibration without normalization
+  assertEqual(INA226_ERR_NONE, REF.setMaxCurrentShunt(20, 0.002, false));
+  assertEqual(REF.getCalibration(), INA.getCalibration());
+  assertEqual(REF.convertCurrent_uA(12345), INA.convertCurrent_uA(12345));
+  assertEqual(REF.convertPower_uW(12345), INA.convertPower_uW(12345));
+  assertEqualFloat(REF.getCurrentLSB(), INA.getCurrentLSB(), 1e-9);
+
+  emu.setShuntVoltage(0.010);
+  assertTrue(INA.waitConversionReady());
+  assertEqualFloat(5000000, INA.getCurrentInt_uA(), 1000);
+
+  //  calibrate() resets the range and converts a typed limit again.
+  assertTrue(INA.setPowerOverLimit(5.0));
+  uint16_t limit = emu.peekRegister(0x07);
+  assertTrue(INA.setAutoRange(true));
+  emu.setShuntVoltage(0.0001);
+  delay(10);
+  INA226Reading reading;
+  assertTrue(INA.read(reading));
+  assertMore(INA.getRange(), 0);
+  assertNotEqual(limit, emu.peekRegister(0x07));
+  assertTrue(INA.calibrate());
+  assertFalse(INA.getAutoRange());
+  assertEqual(0, INA.getRange());
+  assertEqual(4194, emu.peekRegister(0x05));
+  assertEqual(limit, emu.peekRegister(0x07));
+  assertEqualFloat(5.0, INA.getAlertLimitValue(), 0.0001);
+}
+
+
+unittest_main()
+
+
+//  -- END OF FILE --
@@ -0,0 +1,120 @@
+//
+//    FILE: unit_test_queue_threads.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: unit tests for the INA226Queue with a producer and consumer thread
+//          https://github.com/RobTillaart/INA226
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+// supported assertions
+// ----------------------------
+// assertEqual(expected, actual);               // a == b
+// assertNotEqual(unwanted, actual);            // a != b
+// assertComparativeEquivalent(expected, actual);    // abs(a - b) == 0 or (!(a > b) && !(a < b))
+// assertComparativeNotEquivalent(unwanted, actual); // abs(a - b) > 0  or ((a > b) || (a < b))
+// assertLess(upperBound, actual);              // a < b
+// assertMore(lowerBound, actual);              // a > b
+// assertLessOrEqual(upperBound, actual);       // a <= b
+// assertMoreOrEqual(lowerBound, actual);       // a >= b
+// assertTrue(actual);
+// assertFalse(actual);
+// assertNull(actual);
+
+// // special cases for floats
+// assertEqualFloat(expected, actual, epsilon);    // fabs(a - b) <= epsilon
+// assertNotEqualFloat(unwanted, actual, epsilon); // fabs(a - b) >= epsilon
+// assertInfinity(actual);                         // isinf(a)
+// assertNotInfinity(actual);                      // !isinf(a)
+// assertNAN(arg);                                 // isnan(a)
+// assertNotNAN(arg);                              // !isnan(a)
+
+#include <ArduinoUnitTests.h>
+
+#include <atomic>
+#include <thread>
+
+#include "INA226.h"
+#include "INA226Queue.h"
+#include "INA226_emulator.h"
+
+
+unittest_setup()
+{
+  fprintf(stderr, "\n INA226_LIB_VERSION: %s\n", (char *) INA226_LIB_VERSION);
+}
+
+unittest_teardown()
+{
+}
+
+
+//  producer thread reads the emulated device, consumer thread drains.
+unittest(test_queue_threads)
+{
+  INA226_emulator emu(0x40);
+  INA226 INA(0x40, &emu);
+  INA226Queue<16> queue;
+
+  assertTrue(INA.begin());
+  INA.beginConfig();
+  INA.setBusVoltageConversionTime(INA226_140_us);
+  INA.setShuntVoltageConversionTime(INA226_140_us);
+  INA.setModeShuntBusContinuous();
+  INA.commitConfig();
+
+  const uint32_t SAMPLES = 500;
+  std::atomic<bool> running(true);
+  uint32_t produced = 0;
+
+  std::thread producer([&]()
+  {
+    while (running)
+    {
+      if (queue.update(&INA)) produced++;
+      //  the host clock only advances with delay(), e.g. I2C time.
+      delayMicroseconds(20);
+    }
+  });
+
+  uint32_t consumed = 0;
+  uint32_t errors   = 0;
+  uint32_t last     = 0;
+  std::thread consumer([&]()
+  {
+    INA226Sample sample;
+    //  bounded by iterations, the host clock does not advance here.
+    for (uint32_t i = 0; (i < 10000000UL) && (consumed < SAMPLES); i++)
+    {
+      if (queue.pop(sample))
+      {
+        if ((consumed > 0) && (sample.timestamp < last)) errors++;
+        last = sample.timestamp;
+        consumed++;
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  consumer.join();
+  running = false;
+  producer.join();
+
+  INA226Sample sample;
+  while (queue.pop(sample)) consumed++;
+
+  assertMoreOrEqual(consumed, SAMPLES);
+  assertEqual(0, errors);
+  //  every queued sample is consumed.
+  assertEqual(produced, consumed);
+  assertMoreOrEqual(emu.getConversionCount(), consumed);
+}
+
+
+unittest_main()
+
+
+//  -- END OF FILE --
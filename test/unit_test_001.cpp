@@ -33,6 +33,12 @@
 
 
 #include "INA226.h"
+#include "INA226Array.h"
+#include "INA226Sampler.h"
+#include "INA226Energy.h"
+#include "INA226Statistics.h"
+#include "INA226Filter.h"
+#include "INA226Record.h"
 
 
 
@@ -143,6 +149,24 @@ unittest(test_configuration)
 
   assertFalse(INA.setShuntVoltageConversionTime(8));
   assertFalse(INA.setShuntVoltageConversionTime(255));
+
+  //  getters use the cached CONFIGURATION register, power on defaults
+  assertEqual(INA226_1_SAMPLE, INA.getAverage());
+  assertEqual(INA226_1100_us, INA.getBusVoltageConversionTime());
+  assertEqual(INA226_1100_us, INA.getShuntVoltageConversionTime());
+  assertEqual(7, INA.getMode());
+
+  INA.beginConfig();
+  assertTrue(INA.setAverage(INA226_16_SAMPLES));
+  assertTrue(INA.setBusVoltageConversionTime(INA226_204_us));
+  assertTrue(INA.setShuntVoltageConversionTime(INA226_8300_us));
+  assertTrue(INA.setMode(3));
+  assertTrue(INA.commitConfig());
+
+  assertEqual(INA226_16_SAMPLES, INA.getAverage());
+  assertEqual(INA226_204_us, INA.getBusVoltageConversionTime());
+  assertEqual(INA226_8300_us, INA.getShuntVoltageConversionTime());
+  assertEqual(3, INA.getMode());
 }
 
 
@@ -170,6 +194,30 @@ unittest(test_calibration)
 }
 
 
+unittest(test_integer_conversion)
+{
+  INA226 INA(0x40);
+
+  Wire.begin();
+
+  //  not calibrated
+  assertEqual(0, INA.convertCurrent_uA(100));
+  assertEqual(0, INA.convertPower_uW(100));
+
+  //  fixed scales
+  assertEqual(250, INA.convertShuntVoltage_uV(100));
+  assertEqual(-250, INA.convertShuntVoltage_uV(-100));
+  assertEqual(5000, INA.convertBusVoltage_mV(4000));
+
+  //  current_LSB = 50 uA
+  assertEqual(INA226_ERR_NONE, INA.setMaxCurrentShunt(1, 0.05));
+  assertEqualFloat(50, INA.getCurrentLSB_uA(), 0.01);
+  assertEqual(5000, INA.convertCurrent_uA(100));
+  assertEqual(-5000, INA.convertCurrent_uA(-100));
+  assertEqual(125000, INA.convertPower_uW(100));
+}
+
+
 unittest(test_setMode)
 {
   INA226 INA(0x40);
@@ -193,6 +241,345 @@ unittest(test_setMode)
 }
 
 
+unittest(test_alert_interrupt)
+{
+  INA226 INA(0x40);
+  INA226Sample sample;
+
+  Wire.begin();
+
+  assertFalse(INA.isAlertPending());
+  assertFalse(INA.serviceAlert(sample));
+  INA.alertInterrupt();
+  assertTrue(INA.isAlertPending());
+  //  no device => read error, the alert stays pending,
+  //  or no conversion ready, the alert is serviced.
+  assertFalse(INA.serviceAlert(sample));
+  assertEqual(! INA.isValid(), INA.isAlertPending());
+}
+
+
+unittest(test_conversion_period)
+{
+  INA226 INA(0x40);
+
+  Wire.begin();
+
+  //  power on default, mode 7, 1 sample, 1100 us
+  assertEqual(2200, INA.getConversionPeriod_us());
+  INA.beginConfig();
+  INA.setAverage(INA226_4_SAMPLES);
+  assertEqual(8800, INA.getConversionPeriod_us());
+  INA.setAverage(INA226_1024_SAMPLES);
+  INA.setShuntVoltageConversionTime(INA226_8300_us);
+  INA.setMode(5);  //  shunt only
+  assertEqual(8499200, INA.getConversionPeriod_us());
+  INA.setMode(0);
+  assertEqual(0, INA.getConversionPeriod_us());
+}
+
+
+unittest(test_sample_rate)
+{
+  INA226 INA(0x40);
+
+  Wire.begin();
+
+  assertFalse(INA.setSampleRate(0));
+  assertFalse(INA.setSampleRate(10, 0));
+  assertFalse(INA.setSampleRate(10, 4));
+  //  2 x 140 us does not fit in 200 us, config unchanged
+  assertFalse(INA.setSampleRate(5000));
+  assertEqual(2200, INA.getConversionPeriod_us());
+
+  //  10000 us budget
+  assertTrue(INA.setSampleRate(100));
+  assertEqual(7, INA.getMode());
+  assertLessOrEqual(INA.getConversionPeriod_us(), 10000);
+  //  most averaging first
+  assertEqual(INA226_16_SAMPLES, INA.getAverage());
+  assertEqual(INA226_332_us, INA.getShuntVoltageConversionTime());
+  assertEqual(INA226_204_us, INA.getBusVoltageConversionTime());
+  assertEqual(8576, INA.getConversionPeriod_us());
+  assertEqualFloat(116.604, INA.getSampleRate(), 0.01);
+
+  assertTrue(INA.setSampleRate(10));
+  assertEqual(INA226_256_SAMPLES, INA.getAverage());
+  assertEqual(88064, INA.getConversionPeriod_us());
+
+  //  very low rates are clamped to the longest cycle.
+  assertTrue(INA.setSampleRate(0.0001));
+  assertEqual(INA226_1024_SAMPLES, INA.getAverage());
+  assertEqual(16998400, INA.getConversionPeriod_us());
+
+  //  shunt only, triggered, minimal 1100 us
+  assertTrue(INA.setSampleRate(1, 1, INA226_1100_us));
+  assertEqual(1, INA.getMode());
+  assertEqual(INA226_1100_us, INA.getBusVoltageConversionTime());
+  assertLessOrEqual(INA.getConversionPeriod_us(), 1000000);
+  assertFalse(INA.setSampleRate(1000, 1, INA226_1100_us));
+}
+
+
+unittest(test_array)
+{
+  INA226 INA0(0x40);
+  INA226 INA1(0x41);
+  INA226Array arr;
+
+  assertEqual(0, arr.count());
+  assertTrue(arr.add(&INA0));
+  assertTrue(arr.add(&INA1));
+  assertFalse(arr.add(NULL));
+  assertEqual(2, arr.count());
+  assertEqual(&INA1, arr.get(1));
+  assertNull(arr.get(2));
+  assertEqual(0, arr.getSampleCount());
+}
+
+
+unittest(test_sampler)
+{
+  INA226 INA(0x40);
+  INA226Sampler<4> sampler(&INA);
+  INA226Sample s;
+  INA226Sample buffer[4];
+
+  assertEqual(4, sampler.capacity());
+  assertTrue(sampler.isEmpty());
+  assertFalse(sampler.pop(s));
+
+  //  overwrite oldest
+  for (int i = 0; i < 6; i++)
+  {
+    s.timestamp = i;
+    assertTrue(sampler.push(s));
+  }
+  assertTrue(sampler.isFull());
+  assertEqual(2, sampler.getDropped());
+  assertTrue(sampler.pop(s));
+  assertEqual(2, s.timestamp);
+  assertEqual(3, sampler.drain(buffer, 4));
+  assertEqual(5, buffer[2].timestamp);
+  assertTrue(sampler.isEmpty());
+
+  //  drop newest
+  sampler.clear();
+  sampler.setPolicy(INA226_DROP_NEWEST);
+  for (int i = 0; i < 6; i++)
+  {
+    s.timestamp = i;
+    sampler.push(s);
+  }
+  assertEqual(2, sampler.getDropped());
+  assertEqual(4, sampler.drain(buffer, 4));
+  assertEqual(0, buffer[0].timestamp);
+  assertEqual(3, buffer[3].timestamp);
+}
+
+
+unittest(test_energy)
+{
+  INA226 INA(0x40);
+  INA226Energy energy(&INA);
+  INA226Sample s;
+
+  Wire.begin();
+  //  current_LSB = 50 uA, power_LSB = 1.25 mW
+  assertEqual(INA226_ERR_NONE, INA.setMaxCurrentShunt(1, 0.05));
+
+  //  1 A, 12 W, one sample per second during one hour
+  s.current = 20000;
+  s.power   = 9600;
+  for (uint32_t t = 0; t <= 3600; t++)
+  {
+    s.timestamp = t * 1000000UL;
+    energy.add(s);
+  }
+  assertEqual(3600, energy.getSampleCount());
+  assertEqualFloat(3600, energy.getSeconds(), 0.01);
+  assertEqualFloat(1.0, energy.getAmpereHour(), 0.0001);
+  assertEqualFloat(3600, energy.getCoulomb(), 0.5);
+  assertEqualFloat(12.0, energy.getWattHour(), 0.001);
+
+  energy.reset();
+  assertEqual(0, energy.getSampleCount());
+  assertEqualFloat(0, energy.getWattHour(), 0.0001);
+}
+
+
+unittest(test_statistics)
+{
+  INA226 INA(0x40);
+  INA226Statistics stats(&INA);
+  INA226Sample s;
+
+  assertEqual(0, stats.current.count());
+  assertEqualFloat(0, stats.current.mean(), 0.0001);
+
+  //  large offset, small variation
+  for (int i = 0; i < 1000; i++)
+  {
+    s.shunt   = 30000 + (i % 2);
+    s.bus     = 100 + i;
+    s.current = -10;
+    s.power   = 65535;
+    stats.add(s);
+  }
+  assertEqual(1000, stats.shunt.count());
+  assertEqual(30000, stats.shunt.minimum());
+  assertEqual(30001, stats.shunt.maximum());
+  assertEqualFloat(30000.5, stats.shunt.mean(), 0.01);
+  assertEqualFloat(0.25025, stats.shunt.variance(), 0.0001);
+  assertEqualFloat(599.5, stats.bus.mean(), 0.01);
+  assertEqualFloat(-10, stats.current.mean(), 0.0001);
+  assertEqualFloat(0, stats.current.stddev(), 0.0001);
+  assertEqual(65535, stats.power.maximum());
+
+  stats.reset();
+  assertEqual(0, stats.bus.count());
+
+  //  mean drifts far away from the first sample
+  INA226Stat drift;
+  double sum = 0;
+  double sumSq = 0;
+  for (int32_t i = 0; i < 100000; i++)
+  {
+    int32_t value = (i == 0) ? -32768 : 32000 + (i % 3);
+    drift.add(value);
+    sum   += value;
+    sumSq += (double)value * value;
+  }
+  double variance = (sumSq - sum * sum / 100000) / 99999;
+  assertEqualFloat(variance, drift.variance(), variance * 1e-4);
+}
+
+
+unittest(test_filter)
+{
+  INA226Filter<INA226_FILTER_BOXCAR, 4> boxcar;
+  assertTrue(boxcar.add(4));
+  assertEqual(4, boxcar.get());
+  assertTrue(boxcar.add(8));
+  assertEqual(6, boxcar.get());
+  boxcar.add(12);
+  boxcar.add(16);
+  assertEqual(10, boxcar.get());
+  boxcar.add(20);
+  assertEqual(14, boxcar.get());
+
+  boxcar.reset();
+  boxcar.setDecimation(2);
+  assertFalse(boxcar.add(-4));
+  assertTrue(boxcar.add(-8));
+  assertEqual(-6, boxcar.get());
+
+  INA226Filter<INA226_FILTER_DECIMATE, 3> decimate;
+  assertEqual(3, decimate.getDecimation());
+  assertFalse(decimate.add(100));
+  assertFalse(decimate.add(101));
+  assertTrue(decimate.add(105));
+  assertEqual(102, decimate.get());
+
+  INA226Filter<INA226_FILTER_EXPONENTIAL, 2> expo;
+  assertTrue(expo.add(1000));
+  assertEqual(1000, expo.get());
+  for (int i = 0; i < 100; i++) expo.add(2000);
+  assertEqual(2000, expo.get());
+}
+
+
+unittest(test_record)
+{
+  INA226RecordEncoder encoder;
+  INA226RecordDecoder decoder;
+  INA226Record record;
+  uint8_t buffer[3 * INA226_RECORD_MAX_SIZE];
+
+  INA226Sample sample;
+  sample.timestamp = 1000000;
+  sample.shunt     = -1234;
+  sample.bus       = 9600;
+  sample.current   = -2468;
+  sample.power     = 1184;
+
+  //  first record absolute, next delta, then absolute after a gap.
+  uint8_t n = 0;
+  assertEqual(INA226_RECORD_MAX_SIZE, encoder.encode(buffer, 0x45, sample));
+  n += INA226_RECORD_MAX_SIZE;
+  sample.timestamp += 1100;
+  assertEqual(INA226_RECORD_SIZE, encoder.encode(buffer + n, 5, sample));
+  n += INA226_RECORD_SIZE;
+  sample.timestamp += 100000;
+  assertEqual(INA226_RECORD_MAX_SIZE, encoder.encode(buffer + n, 5, sample));
+  n += INA226_RECORD_MAX_SIZE;
+  assertEqual(3, encoder.getSequence());
+
+  //  incomplete and resync
+  assertEqual(INA226_RECORD_INCOMPLETE, decoder.decode(buffer, 10, record));
+  assertEqual(INA226_RECORD_INVALID, decoder.decode(buffer + 1, n - 1, record));
+
+  int16_t rv = decoder.decode(buffer, n, record);
+  assertEqual(INA226_RECORD_MAX_SIZE, rv);
+  assertEqual(5, record.device);
+  assertEqual(0, record.sequence);
+  assertEqual(1000000, record.timestamp);
+  assertEqual(-1234, record.shunt);
+  assertEqual(9600, record.bus);
+  assertEqual(-2468, record.current);
+  assertEqual(1184, record.power);
+
+  rv = decoder.decode(buffer + INA226_RECORD_MAX_SIZE, n, record);
+  assertEqual(INA226_RECORD_SIZE, rv);
+  assertEqual(1001100, record.timestamp);
+
+  //  corrupt the checksum
+  buffer[n - 1]++;
+  assertEqual(INA226_RECORD_INVALID, decoder.decode(buffer + n - INA226_RECORD_MAX_SIZE, INA226_RECORD_MAX_SIZE, record));
+  buffer[n - 1]--;
+  //  sequence number skips one
+  buffer[n - INA226_RECORD_MAX_SIZE + 2]++;
+  buffer[n - 1]++;
+  rv = decoder.decode(buffer + n - INA226_RECORD_MAX_SIZE, INA226_RECORD_MAX_SIZE, record);
+  assertEqual(INA226_RECORD_MAX_SIZE, rv);
+  assertEqual(1101100, record.timestamp);
+  assertEqual(1, decoder.getLost());
+
+  //  lost delta record, the next delta record must not be accepted.
+  encoder.reset();
+  decoder.reset();
+  n = 0;
+  sample.timestamp = 1000;
+  n += encoder.encode(buffer + n, 5, sample);
+  sample.timestamp = 2000;
+  n += encoder.encode(buffer + n, 5, sample);
+  sample.timestamp = 3000;
+  n += encoder.encode(buffer + n, 5, sample);
+  assertEqual(INA226_RECORD_MAX_SIZE + 2 * INA226_RECORD_SIZE, n);
+  buffer[INA226_RECORD_MAX_SIZE + 4]++;
+  assertEqual(INA226_RECORD_MAX_SIZE, decoder.decode(buffer, n, record));
+  assertEqual(1000, record.timestamp);
+  assertEqual(INA226_RECORD_INVALID, decoder.decode(buffer + INA226_RECORD_MAX_SIZE, INA226_RECORD_SIZE, record));
+  assertEqual(INA226_RECORD_INVALID, decoder.decode(buffer + INA226_RECORD_MAX_SIZE + INA226_RECORD_SIZE, INA226_RECORD_SIZE, record));
+  assertEqual(0, decoder.getLost());
+
+  //  periodic absolute record resyncs the decoder.
+  uint8_t record_size = 0;
+  while (encoder.getSequence() != INA226_RECORD_RESYNC)
+  {
+    sample.timestamp += 1000;
+    assertEqual(INA226_RECORD_SIZE, encoder.encode(buffer, 5, sample));
+  }
+  sample.timestamp += 1000;
+  record_size = encoder.encode(buffer, 5, sample);
+  assertEqual(INA226_RECORD_MAX_SIZE, record_size);
+  assertEqual(INA226_RECORD_MAX_SIZE, decoder.decode(buffer, record_size, record));
+  assertEqual(INA226_RECORD_RESYNC, record.sequence);
+  assertEqual(sample.timestamp, record.timestamp);
+  assertEqual(INA226_RECORD_RESYNC - 1, decoder.getLost());
+}
+
+
 unittest_main()
 
 
@@ -0,0 +1,87 @@
+//
+//    FILE: unit_test_003.cpp
+//  AUTHOR: Rob Tillaart
+//    DATE: 2026-10-17
+// PURPOSE: unit tests for the INA226Queue
+//          https://github.com/RobTillaart/INA226
+//          https://github.com/Arduino-CI/arduino_ci/blob/master/REFERENCE.md
+//
+
+// supported assertions
+// ----------------------------
+// assertEqual(expected, actual);               // a == b
+// assertNotEqual(unwanted, actual);            // a != b
+// assertComparativeEquivalent(expected, actual);    // abs(a - b) == 0 or (!(a > b) && !(a < b))
+// assertComparativeNotEquivalent(unwanted, actual); // abs(a - b) > 0  or ((a > b) || (a < b))
+// assertLess(upperBound, actual);              // a < b
+// assertMore(lowerBound, actual);              // a > b
+// assertLessOrEqual(upperBound, actual);       // a <= b
+// assertMoreOrEqual(lowerBound, actual);       // a >= b
+// assertTrue(actual);
+// assertFalse(actual);
+// assertNull(actual);
+
+// // special cases for floats
+// assertEqualFloat(expected, actual, epsilon);    // fabs(a - b) <= epsilon
+// assertNotEqualFloat(unwanted, actual, epsilon); // fabs(a - b) >= epsilon
+// assertInfinity(actual);                         // isinf(a)
+// assertNotInfinity(actual);                      // !isinf(a)
+// assertNAN(arg);                                 // isnan(a)
+// assertNotNAN(arg);                              // !isnan(a)
+
+#include <ArduinoUnitTests.h>
+
+#include "INA226.h"
+#include "INA226Queue.h"
+
+
+unittest_setup()
+{
+  fprintf(stderr, "\n INA226_LIB_VERSION: %s\n", (char *) INA226_LIB_VERSION);
+}
+
+unittest_teardown()
+{
+}
+
+
+unittest(test_queue)
+{
+  INA226Queue<4> queue;
+  INA226Sample sample;
+
+  assertEqual(4, queue.capacity());
+  assertTrue(queue.isEmpty());
+  assertFalse(queue.pop(sample));
+
+  for (uint16_t i = 0; i < 5; i++)
+  {
+    sample.timestamp = i;
+    sample.shunt     = i;
+    assertEqual(i < 4, queue.push(sample));
+  }
+  assertTrue(queue.isFull());
+  assertEqual(1, queue.getDropped());
+
+  INA226Sample buffer[8];
+  assertTrue(queue.pop(sample));
+  assertEqual(0, sample.shunt);
+  assertEqual(3, queue.drain(buffer, 8));
+  assertEqual(3, buffer[2].shunt);
+  assertTrue(queue.isEmpty());
+
+  //  indices wrap around
+  for (uint16_t i = 0; i < 1000; i++)
+  {
+    sample.shunt = i;
+    assertTrue(queue.push(sample));
+    assertTrue(queue.pop(sample));
+    assertEqual(i, sample.shunt);
+  }
+}
+
+
+unittest_main()
+
+
+//  -- END OF FILE --